@@ -51,8 +51,12 @@
 #include "oled/oled_test.h"
 #include "oled/Adafruit_GFX.h"
 #include "oled/glcdfont.h"
+#include "oled/display_list.h"
+#include "oled/text_field.h"
+#include "oled/save_under.h"
 
 #include "tank_art.h"
+#include "tank_sprites.h"
 
 #define APPLICATION_VERSION     "1.4.0"
 //*****************************************************************************
@@ -129,6 +133,7 @@ volatile unsigned long data = 0;
 typedef struct {
     int x, y;
     int direction;  // This will be in the range of [0, 360) to represent direction in degrees
+    SaveUnder under;  // what the projectile covers
 } Projectile;
 
 #define MAX_PROJECTILES 5  // Maximum number of projectiles in flight at once
@@ -344,66 +349,54 @@ void rotate_triangle(int *x1, int *y1, int *x2, int *y2, int *x3, int *y3, int a
     rotate_point(x3, y3, angle, centroid_x, centroid_y);
 }
 
-//FUNCTIONS FOR CANNON POSITION -----------------
+//FUNCTIONS FOR TANK SPRITE -----------------
 
-void drawCannon(int ball_x, int ball_y, int direction){
-    switch(direction) {
-        case UP:
-            drawLine(ball_x, ball_y, ball_x, ball_y - 12, GREEN);
-            break;
-        case RIGHT:
-            drawLine(ball_x, ball_y, ball_x + 12, ball_y, GREEN);
-            break;
-        case DOWN:
-            drawLine(ball_x, ball_y, ball_x, ball_y + 12, GREEN);
-            break;
-        case LEFT:
-            drawLine(ball_x, ball_y, ball_x - 12, ball_y, GREEN);
-            break;
-        case UP_LEFT:
-            drawLine(ball_x, ball_y, ball_x - 12, ball_y - 12, GREEN);
-            break;
-        case UP_RIGHT:
-            drawLine(ball_x, ball_y, ball_x + 12, ball_y - 12, GREEN);
-            break;
-        case DOWN_LEFT:
-            drawLine(ball_x, ball_y, ball_x - 12, ball_y + 12, GREEN);
-            break;
-        case DOWN_RIGHT:
-            drawLine(ball_x, ball_y, ball_x + 12, ball_y + 12, GREEN);
-            break;
+// With a framebuffer, what the tank and the target cover is saved and put
+// back when they go. Without one the panel cannot be read back, so erasing
+// paints only the pixels that were drawn black, which is cheaper on the bus
+// than filling their whole boxes.
+#ifdef SSD1351_FRAMEBUFFER
+SaveUnder tankUnder, targetUnder;
+#endif
 
+// where the tank was last drawn, -1 before the first frame
+int tank_x, tank_y, tank_dir = -1;
 
-    }
+// the tank, cannon included, is one pre-rendered frame per direction
+void drawTank(int ball_x, int ball_y, int direction) {
+    const SpriteFrame *f = &tankFrames[direction / 45];
+
+#ifdef SSD1351_FRAMEBUFFER
+    saveUnder(&tankUnder, ball_x + f->ox, ball_y + f->oy, f->w, f->h);
+#endif
+    spriteDraw(f, ball_x, ball_y);
+    tank_x = ball_x;
+    tank_y = ball_y;
+    tank_dir = direction;
 }
 
-void eraseCannon(int ball_x, int ball_y, int direction) {
-    switch(direction) {
-        case UP:
-            drawLine(ball_x, ball_y, ball_x, ball_y - 12, BLACK);
-            break;
-        case RIGHT:
-            drawLine(ball_x, ball_y, ball_x + 12, ball_y, BLACK);
-            break;
-        case DOWN:
-            drawLine(ball_x, ball_y, ball_x, ball_y + 12, BLACK);
-            break;
-        case LEFT:
-            drawLine(ball_x, ball_y, ball_x -12, ball_y, BLACK);
-            break;
-        case UP_LEFT:
-            drawLine(ball_x, ball_y, ball_x - 12, ball_y - 12, BLACK);
-            break;
-        case UP_RIGHT:
-            drawLine(ball_x, ball_y, ball_x + 12, ball_y - 12, BLACK);
-            break;
-        case DOWN_LEFT:
-            drawLine(ball_x, ball_y, ball_x - 12, ball_y + 12, BLACK);
-            break;
-        case DOWN_RIGHT:
-            drawLine(ball_x, ball_y, ball_x + 12, ball_y + 12, BLACK);
-            break;
-    }
+void eraseTank(void) {
+#ifdef SSD1351_FRAMEBUFFER
+    restoreUnder(&tankUnder, BLACK);
+#else
+    if (tank_dir >= 0)
+        spriteErase(&tankFrames[tank_dir / 45], tank_x, tank_y, BLACK);
+#endif
+}
+
+void drawTarget(int target_x, int target_y) {
+#ifdef SSD1351_FRAMEBUFFER
+    saveUnder(&targetUnder, target_x - 4, target_y - 4, 9, 9);
+#endif
+    fillCircle(target_x, target_y, 4, RED);
+}
+
+void eraseTarget(int target_x, int target_y) {
+#ifdef SSD1351_FRAMEBUFFER
+    restoreUnder(&targetUnder, BLACK);
+#else
+    fillCircle(target_x, target_y, 4, BLACK);
+#endif
 }
 int proj_velocity = 2;
 
@@ -420,11 +413,46 @@ void fireProjectile(int ball_x, int ball_y, int cannonDir) {
     }
 }
 
-void moveProjectiles() {
+// newest first, the reverse of the order they were drawn in
+void eraseProjectiles() {
+    int i;
+    for (i = num_projectiles - 1; i >= 0; i--) {
+#ifdef SSD1351_FRAMEBUFFER
+        restoreUnder(&projectiles[i].under, BLACK);
+#else
+        drawCircle(projectiles[i].x, projectiles[i].y, 3, BLACK);
+#endif
+    }
+}
+
+#ifndef SSD1351_FRAMEBUFFER
+int boxesOverlap(int ax, int ay, int aw, int ah, int bx, int by, int bw, int bh) {
+    return ax < bx + bw && bx < ax + aw && ay < by + bh && by < ay + ah;
+}
+
+// whether erasing the tank or a projectile painted over the target
+int erasedOverTarget(int target_x, int target_y) {
+    const SpriteFrame *f;
     int i;
+
+    if (tank_dir >= 0) {
+        f = &tankFrames[tank_dir / 45];
+        if (boxesOverlap(tank_x + f->ox, tank_y + f->oy, f->w, f->h,
+                         target_x - 4, target_y - 4, 9, 9))
+            return 1;
+    }
     for (i = 0; i < num_projectiles; i++) {
-        drawCircle(projectiles[i].x, projectiles[i].y, 3, BLACK);  // You can change the size/color
+        if (boxesOverlap(projectiles[i].x - 3, projectiles[i].y - 3, 7, 7,
+                         target_x - 4, target_y - 4, 9, 9))
+            return 1;
+    }
+    return 0;
+}
+#endif
 
+void moveProjectiles() {
+    int i;
+    for (i = 0; i < num_projectiles; i++) {
         // Move the projectile in the direction of cannonDir
         double radian = projectiles[i].direction * (M_PI / 180.0);
         int move_distance = PLAYER_BULLET_SPEED;  // Distance the projectile moves each update
@@ -442,6 +470,9 @@ void moveProjectiles() {
             i--;  // Decrement the index to stay at the same position after removal
         } else {
             // Draw the projectile at its new position
+#ifdef SSD1351_FRAMEBUFFER
+            saveUnder(&projectiles[i].under, projectiles[i].x - 3, projectiles[i].y - 3, 7, 7);
+#endif
             drawCircle(projectiles[i].x, projectiles[i].y, 3, WHITE);  // You can change the size/color
         }
     }
@@ -461,6 +492,7 @@ void titlePage() {
     setTextColor(WHITE, BLACK);
     setCursor(0, 121);
     Outstr("Press any button");
+    flush();
 
     // wait for button press
     while (1) {
@@ -471,6 +503,7 @@ void titlePage() {
 
     // clear screen
     fillScreen(BLACK);
+    flush();
 }
 
 
@@ -513,17 +546,8 @@ void main()
     MAP_SPIReset(GSPI_BASE);
 
 
-    // Configure SPI interface
-    MAP_SPIConfigSetExpClk(GSPI_BASE,MAP_PRCMPeripheralClockGet(PRCM_GSPI),
-                     SPI_IF_BIT_RATE,SPI_MODE_MASTER,SPI_SUB_MODE_0,
-                     (SPI_SW_CTRL_CS |
-                     SPI_4PIN_MODE |
-                     SPI_TURBO_OFF |
-                     SPI_CS_ACTIVEHIGH |
-                     SPI_WL_8));
-
-    // enable SPI
-    MAP_SPIEnable(GSPI_BASE);
+    // Configure SPI interface and enable SPI
+    spiInit(SPI_IF_BIT_RATE);
 
     // enable I2C
     I2C_IF_Open(I2C_MASTER_MODE_FST);
@@ -552,8 +576,14 @@ void main()
     ClearTerm();
 
     Adafruit_Init();
+    asyncInit();
     fillScreen(BLACK);
 
+#ifdef OLED_BENCH
+    // report the driver benchmarks over UART, then play as usual
+    runBenchmarks(tankFrames, (const unsigned char *)tank_art_bits, 128, 128);
+#endif
+
     // display title page
     titlePage();
 
@@ -563,10 +593,13 @@ void main()
 
     signed char acc_x, acc_y;
 
+    // the score line only redraws the digits that change
     int score = 0;
     char scoreStr[20];
+    TextField scoreField;
+    textFieldInit(&scoreField, 0, 0, width(), WHITE, BLACK, 1);
     sprintf(scoreStr, "Score: %d", score);
-    Outstr(scoreStr);
+    textFieldSet(&scoreField, scoreStr);
 
 
 
@@ -589,7 +622,8 @@ void main()
     // put target in random coordinates
     target_x = (rand() % (width()-12)) + 8;
     target_y = (rand() % (height()-20)) + 16;
-    fillCircle(target_x, target_y, 4, RED);
+    drawTarget(target_x, target_y);
+    flush();
 
     int cannonDir = 45;
 
@@ -612,9 +646,16 @@ void main()
     char* button;
     static bool buttonPressed = false;
 
+#ifdef SSD1351_FRAMEBUFFER
+    FlushStats flushStats;
+#endif
+
     while (1) {
         Report("%d ", systick_cnt);
 
+        // collect this frame's drawing, flush() below sends it
+        dlBegin();
+
         //IR STUFF
         //int modAmount = 3;
 
@@ -673,9 +714,17 @@ void main()
 
         //Report(" X: %d, Y: %d\n", acc_x, acc_y);
 
-        //erase previous ball
-        drawCircle(ball_x, ball_y, 6, BLACK);
-        eraseCannon(ball_x, ball_y, cannonDir);
+        // take off what the last frame drew, in reverse order: tank, then
+        // projectiles
+        eraseTank();
+        eraseProjectiles();
+
+#ifndef SSD1351_FRAMEBUFFER
+        // without a framebuffer the erase above was black, so put back the
+        // target if it was under the tank or a projectile
+        if (erasedOverTarget(target_x, target_y))
+            fillCircle(target_x, target_y, 4, RED);
+#endif
 
 
         if ( strcmp(button, "RightButton") == 0 && !buttonPressed) {
@@ -700,8 +749,6 @@ void main()
             buttonPressed = false;  // Reset the button press state
         }
 
-        moveProjectiles();
-
         buttonPressed = false;
         Report("%s", button);
 
@@ -742,31 +789,44 @@ void main()
             ball_y = height()-4;
 
 
-        // put ball in new position
-        drawCircle(ball_x, ball_y, 6, GREEN);
-        drawCannon(ball_x, ball_y, cannonDir);
-
         // check if target reached
         if (abs(ball_x-target_x) < 8 && abs(ball_y-target_y) < 8) {
             score++;
 
             // erase target
-            fillCircle(target_x, target_y, 4, BLACK);
+            eraseTarget(target_x, target_y);
 
             // print new score
-            fillRect(0,0,width(), 8, BLACK);
-            setCursor(0,0);
             sprintf(scoreStr, "Score: %d", score);
-            Outstr(scoreStr);
+            textFieldSet(&scoreField, scoreStr);
 
 
             // put target in new random coordinates
             target_x = (rand() % (width()-12)) + 8;
             target_y = (rand() % (height()-20)) + 16;
-            fillCircle(target_x, target_y, 4, RED);
+            drawTarget(target_x, target_y);
 
         }
 
+        // projectiles, then the tank (with a framebuffer, each saves what
+        // it covers as it draws)
+        moveProjectiles();
+        drawTank(ball_x, ball_y, cannonDir);
+
+        // send the frame: the display list recorded since dlBegin() when
+        // drawing straight to the panel, the dirty areas of the framebuffer
+        // otherwise
+        flush();
+
+#ifdef SSD1351_FRAMEBUFFER
+        // SPI traffic should follow motion, not screen size
+        getFlushStats(&flushStats);
+        Report("px %lu/%d ", flushStats.pixelsSent, width()*height());
+#ifdef SSD1351_ASYNC_FLUSH
+        Report("in flight %lu ", flushStats.framesInFlight);
+#endif
+#endif
+
     };
 
 
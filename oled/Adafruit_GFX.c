@@ -31,9 +31,15 @@ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "Adafruit_GFX.h"
 #include "Adafruit_SSD1351.h"
 #include "glcdfont.h"
+#include "circle_spans.h"
+#include "display_list.h"
+#include "glyph_cache.h"
 #define pgm_read_byte(addr) (*(const unsigned char *)(addr))
 
 int cursor_x=0;
@@ -59,19 +65,82 @@ Adafruit_GFX(int w, int h):
 */
 
 // Draw a circle outline
-void drawCircle(int x0, int y0, int r, unsigned int color) {
+//
+// The midpoint algorithm's points are collected per row instead of plotted:
+// on each row the outline is one contiguous run per side, so a row costs at
+// most two drawFastHLine windows (one when the two runs meet at the top and
+// bottom), instead of one drawPixel window per point. The radii the game uses
+// come straight from circle_spans.h.
+static char circleTables = 1;
+
+void setCircleTables(char enable) {
+  circleTables = enable;
+}
+
+static const CircleSpans *circleLookup(int r) {
+  unsigned int i;
+
+  if (!circleTables) return 0;
+  for (i = 0; i < sizeof(circleSpans)/sizeof(circleSpans[0]); i++) {
+    if (circleSpans[i].r == r) return &circleSpans[i];
+  }
+  return 0;
+}
+
+static void drawCircleSpans(int x0, int y0, int r, const unsigned char *lo,
+                            const unsigned char *hi, unsigned int color) {
+  int dy;
+
+  startWrite();
+  for (dy = 0; dy <= r; dy++) {
+    if (lo[dy] > hi[dy]) continue;
+
+    if (lo[dy] == 0) {
+      drawFastHLine(x0 - hi[dy], y0 + dy, 2*hi[dy] + 1, color);
+      if (dy) drawFastHLine(x0 - hi[dy], y0 - dy, 2*hi[dy] + 1, color);
+    } else {
+      drawFastHLine(x0 + lo[dy], y0 + dy, hi[dy] - lo[dy] + 1, color);
+      drawFastHLine(x0 - hi[dy], y0 + dy, hi[dy] - lo[dy] + 1, color);
+      if (dy) {
+        drawFastHLine(x0 + lo[dy], y0 - dy, hi[dy] - lo[dy] + 1, color);
+        drawFastHLine(x0 - hi[dy], y0 - dy, hi[dy] - lo[dy] + 1, color);
+      }
+    }
+  }
+  endWrite();
+}
+
+// Outline of a radius r circle as row spans: rows y0 +/- dy cover the x
+// offsets lo[dy]..hi[dy] on each side (none when lo[dy] > hi[dy]). r must be
+// below WIDTH.
+void circleOutlineSpans(int r, unsigned char *lo, unsigned char *hi) {
+  const CircleSpans *spans = circleLookup(r);
   int f = 1 - r;
   int ddF_x = 1;
   int ddF_y = -2 * r;
   int x = 0;
   int y = r;
+  int dy;
 
-  drawPixel(x0  , y0+r, color);
-  drawPixel(x0  , y0-r, color);
-  drawPixel(x0+r, y0  , color);
-  drawPixel(x0-r, y0  , color);
+  if (spans) {
+    memcpy(lo, spans->lo, r + 1);
+    memcpy(hi, spans->hi, r + 1);
+    return;
+  }
 
-  while (x<y) {
+  for (dy = 0; dy <= r; dy++) {
+    lo[dy] = WIDTH;
+    hi[dy] = 0;
+  }
+
+  // (0, r) and (r, 0) as the first point, then one octant
+  for (;;) {
+    if (x < lo[y]) lo[y] = x;
+    if (x > hi[y]) hi[y] = x;
+    if (y < lo[x]) lo[x] = y;
+    if (y > hi[x]) hi[x] = y;
+
+    if (x >= y) break;
     if (f >= 0) {
       y--;
       ddF_y += 2;
@@ -80,18 +149,23 @@ void drawCircle(int x0, int y0, int r, unsigned int color) {
     x++;
     ddF_x += 2;
     f += ddF_x;
-  
-    drawPixel(x0 + x, y0 + y, color);
-    drawPixel(x0 - x, y0 + y, color);
-    drawPixel(x0 + x, y0 - y, color);
-    drawPixel(x0 - x, y0 - y, color);
-    drawPixel(x0 + y, y0 + x, color);
-    drawPixel(x0 - y, y0 + x, color);
-    drawPixel(x0 + y, y0 - x, color);
-    drawPixel(x0 - y, y0 - x, color);
   }
 }
 
+void drawCircle(int x0, int y0, int r, unsigned int color) {
+  unsigned char lo[WIDTH], hi[WIDTH];  // run of x offsets on row y0 +/- dy
+  const CircleSpans *spans = circleLookup(r);
+
+  if (spans) {
+    drawCircleSpans(x0, y0, r, spans->lo, spans->hi, color);
+    return;
+  }
+  if (r < 0 || r >= WIDTH) return;
+
+  circleOutlineSpans(r, lo, hi);
+  drawCircleSpans(x0, y0, r, lo, hi, color);
+}
+
 void drawCircleHelper( int x0, int y0,
                int r, unsigned char cornername, unsigned int color) {
   int f     = 1 - r;
@@ -100,6 +174,7 @@ void drawCircleHelper( int x0, int y0,
   int x     = 0;
   int y     = r;
 
+  startWrite();
   while (x<y) {
     if (f >= 0) {
       y--;
@@ -126,12 +201,76 @@ void drawCircleHelper( int x0, int y0,
       drawPixel(x0 - x, y0 - y, color);
     }
   }
+  endWrite();
+}
+
+// Fill a circle with one horizontal span per row. The half-width of a row
+// is the widest midpoint point at or below it, the same pixels the vertical
+// lines of fillCircleHelper would cover.
+static void fillCircleSpans(int x0, int y0, int r, const unsigned char *hw,
+                            unsigned int color) {
+  int dy;
+
+  startWrite();
+  for (dy = 0; dy <= r; dy++) {
+    drawFastHLine(x0 - hw[dy], y0 + dy, 2*hw[dy] + 1, color);
+    if (dy) drawFastHLine(x0 - hw[dy], y0 - dy, 2*hw[dy] + 1, color);
+  }
+  endWrite();
+}
+
+// Fill of a radius r circle as row half-widths: rows y0 +/- dy cover
+// -hw[dy]..hw[dy]. r must be below WIDTH.
+void circleFillSpans(int r, unsigned char *hw) {
+  const CircleSpans *spans = circleLookup(r);
+  int f     = 1 - r;
+  int ddF_x = 1;
+  int ddF_y = -2 * r;
+  int x     = 0;
+  int y     = r;
+  int dy;
+
+  if (spans) {
+    memcpy(hw, spans->hw, r + 1);
+    return;
+  }
+
+  for (dy = 0; dy <= r; dy++) {
+    hw[dy] = 0;
+  }
+
+  while (x<y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f     += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f     += ddF_x;
+
+    // column x0 +/- x spans rows up to y, column x0 +/- y rows up to x
+    if (x <= r && x > hw[y]) hw[y] = x;
+    if (y <= r && y > hw[x]) hw[x] = y;
+  }
+  for (dy = r - 1; dy >= 0; dy--) {
+    if (hw[dy + 1] > hw[dy]) hw[dy] = hw[dy + 1];
+  }
 }
 
 void fillCircle(int x0, int y0, int r,
 			      unsigned int color) {
-  drawFastVLine(x0, y0-r, 2*r+1, color);
-  fillCircleHelper(x0, y0, r, 3, 0, color);
+  unsigned char hw[WIDTH];  // half-width of row y0 +/- dy
+  const CircleSpans *spans = circleLookup(r);
+
+  if (spans) {
+    fillCircleSpans(x0, y0, r, spans->hw, color);
+    return;
+  }
+  if (r < 0 || r >= WIDTH) return;
+
+  circleFillSpans(r, hw);
+  fillCircleSpans(x0, y0, r, hw, color);
 }
 
 // Used to do circles and roundrects
@@ -144,6 +283,7 @@ void fillCircleHelper(int x0, int y0, int r,
   int x     = 0;
   int y     = r;
 
+  startWrite();
   while (x<y) {
     if (f >= 0) {
       y--;
@@ -163,14 +303,71 @@ void fillCircleHelper(int x0, int y0, int r,
       drawFastVLine(x0-y, y0-x, 2*x+1+delta, color);
     }
   }
+  endWrite();
 }
 
 // Bresenham's algorithm - thx wikpedia
+// Bresenham line, emitted run by run: a shallow line is a staircase of
+// horizontal runs and a steep one of vertical runs, so each step of the minor
+// axis closes one drawFastHLine/drawFastVLine burst. Single pixel runs (45
+// degree stretches) go through drawPixel, which can reuse the write pointer.
+static void drawLineRun(int steep, int major, int minor, int len,
+                        unsigned int color) {
+  if (len == 1) {
+    if (steep) drawPixel(minor, major, color);
+    else       drawPixel(major, minor, color);
+  } else if (steep) {
+    drawFastVLine(minor, major, len, color);
+  } else {
+    drawFastHLine(major, minor, len, color);
+  }
+}
+
+// Cohen-Sutherland outcode of x, y against the clip rectangle
+#define CLIP_LEFT   1
+#define CLIP_RIGHT  2
+#define CLIP_TOP    4
+#define CLIP_BOTTOM 8
+
+static int clipOutcode(int x, int y, int cx0, int cy0, int cx1, int cy1) {
+  int code = 0;
+
+  if (x < cx0) code |= CLIP_LEFT;
+  else if (x > cx1) code |= CLIP_RIGHT;
+  if (y < cy0) code |= CLIP_TOP;
+  else if (y > cy1) code |= CLIP_BOTTOM;
+  return code;
+}
+
+// Lines with both ends on the same outside side of the clip rectangle are
+// dropped before any SPI traffic. A line that crosses an edge starts at the
+// first step of the major axis inside the rectangle, with the Bresenham
+// error it would have had there, so the visible pixels are exactly those of
+// the unclipped line.
 void drawLine(int x0, int y0, int x1, int y1, unsigned int color) {
   int steep;
   int dx, dy;
 	int err;
 	int ystep;
+  int run;
+  int cx0, cy0, cx1, cy1, code0, code1;
+  int majMin, majMax, minMin, minMax, lo, hi, first, last, n;
+
+  getClipRect(&cx0, &cy0, &cx1, &cy1);
+  code0 = clipOutcode(x0, y0, cx0, cy0, cx1, cy1);
+  code1 = clipOutcode(x1, y1, cx0, cy0, cx1, cy1);
+  if (code0 & code1) return;
+
+  if (y0 == y1) {
+    if (x0 > x1) swap(x0, x1);
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    return;
+  }
+  if (x0 == x1) {
+    if (y0 > y1) swap(y0, y1);
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    return;
+  }
 						
 	steep = abs(y1 - y0) > abs(x1 - x0);
   if (steep) {
@@ -194,28 +391,59 @@ void drawLine(int x0, int y0, int x1, int y1, unsigned int color) {
     ystep = -1;
   }
 
-  for (; x0<=x1; x0++) {
-    if (steep) {
-      drawPixel(y0, x0, color);
-    } else {
-      drawPixel(x0, y0, color);
+  if (code0 | code1) {
+    majMin = steep ? cy0 : cx0;
+    majMax = steep ? cy1 : cx1;
+    minMin = steep ? cx0 : cy0;
+    minMax = steep ? cx1 : cy1;
+
+    // steps k = 0..dx along the major axis inside the rectangle; step k is
+    // n(k) = max(0, ceil((k*dy - err)/dx)) steps along the minor axis
+    first = majMin > x0 ? majMin - x0 : 0;
+    last = majMax < x1 ? majMax - x0 : dx;
+    lo = ystep > 0 ? minMin - y0 : y0 - minMax;
+    hi = ystep > 0 ? minMax - y0 : y0 - minMin;
+    if (hi < 0) return;
+    if (lo > 0 && ((lo - 1) * dx + err) / dy + 1 > first) {
+      first = ((lo - 1) * dx + err) / dy + 1;
     }
+    if ((hi * dx + err) / dy < last) last = (hi * dx + err) / dy;
+    if (first > last) return;
+
+    n = first * dy > err ? (first * dy - err + dx - 1) / dx : 0;
+    err += n * dx - first * dy;
+    x0 += first;
+    x1 = x0 + last - first;
+    y0 += ystep * n;
+  }
+
+  startWrite();
+  run = x0;
+  for (; x0<=x1; x0++) {
     err -= dy;
     if (err < 0) {
+      drawLineRun(steep, run, y0, x0 - run + 1, color);
+      run = x0 + 1;
       y0 += ystep;
       err += dx;
     }
   }
+  if (run <= x1) {
+    drawLineRun(steep, run, y0, x1 - run + 1, color);
+  }
+  endWrite();
 }
 
 // Draw a rectangle
 void drawRect(int x, int y,
 			    int w, int h,
 			    unsigned int color) {
+  startWrite();
   drawFastHLine(x, y, w, color);
   drawFastHLine(x, y+h-1, w, color);
   drawFastVLine(x, y, h, color);
   drawFastVLine(x+w-1, y, h, color);
+  endWrite();
 }
 /*
 void drawFastVLine(int x, int y,
@@ -249,6 +477,7 @@ void fillScreen(unsigned int color) {
 void drawRoundRect(int x, int y, int w,
   int h, int r, unsigned int color) {
   // smarter version
+  startWrite();
   drawFastHLine(x+r  , y    , w-2*r, color); // Top
   drawFastHLine(x+r  , y+h-1, w-2*r, color); // Bottom
   drawFastVLine(x    , y+r  , h-2*r, color); // Left
@@ -258,26 +487,31 @@ void drawRoundRect(int x, int y, int w,
   drawCircleHelper(x+w-r-1, y+r    , r, 2, color);
   drawCircleHelper(x+w-r-1, y+h-r-1, r, 4, color);
   drawCircleHelper(x+r    , y+h-r-1, r, 8, color);
+  endWrite();
 }
 
 // Fill a rounded rectangle
 void fillRoundRect(int x, int y, int w,
 				 int h, int r, unsigned int color) {
   // smarter version
+  startWrite();
   fillRect(x+r, y, w-2*r, h, color);
 
   // draw four corners
   fillCircleHelper(x+w-r-1, y+r, r, 1, h-2*r-1, color);
   fillCircleHelper(x+r    , y+r, r, 2, h-2*r-1, color);
+  endWrite();
 }
 
 // Draw a triangle
 void drawTriangle(int x0, int y0,
 				int x1, int y1,
 				int x2, int y2, unsigned int color) {
+  startWrite();
   drawLine(x0, y0, x1, y1, color);
   drawLine(x1, y1, x2, y2, color);
   drawLine(x2, y2, x0, y0, color);
+  endWrite();
 }
 
 // Fill a triangle
@@ -329,6 +563,7 @@ void fillTriangle ( int x0, int y0,
   if(y1 == y2) last = y1;   // Include y1 scanline
   else         last = y1-1; // Skip it
 
+  startWrite();
   for(y=y0; y<=last; y++) {
     a   = x0 + sa / dy01;
     b   = x0 + sb / dy02;
@@ -358,6 +593,7 @@ void fillTriangle ( int x0, int y0,
     if(a > b) swap(a,b);
     drawFastHLine(a, y, b-a+1, color);
   }
+  endWrite();
 }
 /*
 void drawBitmap(int x, int y,
@@ -398,31 +634,188 @@ void drawBitmap(int x, int y,
 }
 */
 
+// Count trailing zeros of a nonzero word: isolate the lowest set bit and
+// count the zeros above it with the CLZ instruction
+#ifdef __TI_COMPILER_VERSION__
+#define CLZ(x) _norm(x)
+#else
+#define CLZ(x) __builtin_clz(x)
+#endif
+#define CTZ(x) (31 - CLZ((x) & (0U - (x))))
+
+// Up to 32 bits of an XBM row from column col (bit 0 = col), stopping at
+// column to; the number of columns read is left in *valid
+static unsigned int xbmBits(const unsigned char *row, int col, int to,
+                            int *valid) {
+  unsigned int bits = 0;
+  int b = col >> 3;
+  int n = ((to + 7) >> 3) - b;
+  int k;
+
+  if (n > 4) n = 4;
+  for (k = 0; k < n; k++) {
+    bits |= (unsigned int)row[b + k] << (8 * k);
+  }
+  bits >>= col & 7;
+
+  *valid = 32 - (col & 7);
+  if (*valid > to - col) *valid = to - col;
+  if (*valid < 32) bits &= (1U << *valid) - 1;
+  return bits;
+}
+
+// First run of set bits in columns from..to-1 of an XBM row: its start in
+// *start and its length, or 0 if there is none
+int xbmNextRun(const unsigned char *row, int from, int to, int *start) {
+  unsigned int bits;
+  int col = from;
+  int valid;
+
+  // next set bit
+  for (;;) {
+    if (col >= to) return 0;
+    bits = xbmBits(row, col, to, &valid);
+    if (bits) break;
+    col += valid;
+  }
+  col += CTZ(bits);
+  *start = col;
+
+  // next clear bit
+  while (col < to) {
+    bits = ~xbmBits(row, col, to, &valid);
+    if (valid < 32) bits &= (1U << valid) - 1;
+    if (bits) {
+      col += CTZ(bits);
+      break;
+    }
+    col += valid;
+  }
+  return col - *start;
+}
+
 //Draw XBitMap Files (*.xbm), exported from GIMP,
 //Usage: Export from GIMP to *.xbm, rename *.xbm to *.c and open in editor.
 //C Array can be directly used with this function
+//
+// Each row is scanned a word at a time and every run of set bits is drawn
+// as one horizontal line.
  void drawXBitmap(int x, int y,
                                const unsigned char *bitmap, int w, int h,
                                unsigned int color) {
   
-   int i, j, byteWidth = (w + 7) / 8;
+   int j, byteWidth = (w + 7) / 8;
+   int from, to, top, bottom, col, start, len;
   
-   for(j=0; j<h; j++) {
-     for(i=0; i<w; i++ ) {
-        if(pgm_read_byte(bitmap + j * byteWidth + i / 8) & (1 << (i % 8))) {
-            drawPixel(x+i, y+j, color);
-        }
+   // the part of the bitmap inside the clip rectangle
+   if (!clipImage(x, y, w, h, &from, &to, &top, &bottom)) return;
+
+   startWrite();
+   for(j=top; j<bottom; j++) {
+     for (col = from; (len = xbmNextRun(bitmap + j * byteWidth, col, to, &start));
+          col = start + len) {
+        drawFastHLine(x+start, y+j, len, color);
      }
    }
+   endWrite();
  }
 
-void custom_drawBitMap(int w, int h, const unsigned int* colors) {
-  int i, j;
-  for (i = 0; i < w; i++) {
-    for (j = 0; j < h; j++) {
-      drawPixel(i, j, colors[i + j * w]);
+// Appends n pixels of color to the pending run, sending the run when the
+// colour changes
+static void xbmPush(unsigned int color, unsigned long n,
+                    unsigned int *runColor, unsigned long *run) {
+  if (color != *runColor && *run) {
+    pushColor(*runColor, *run);
+    *run = 0;
+  }
+  *runColor = color;
+  *run += n;
+}
+
+// Opaque XBM: clear bits are drawn in bg, and the visible part of the
+// bitmap goes out as one window
+void drawXBitmapOpaque(int x, int y, const unsigned char *bitmap, int w, int h,
+                       unsigned int color, unsigned int bg) {
+  int j, byteWidth = (w + 7) / 8;
+  int from, to, top, bottom, col, start, len;
+  unsigned int runColor = bg;
+  unsigned long run = 0;
+
+  if (!clipImage(x, y, w, h, &from, &to, &top, &bottom)) return;
+
+  // ops recorded so far must reach the panel before this does
+  dlSync();
+
+  startWrite();
+  setAddrWindow(x + from, y + top, x + to - 1, y + bottom - 1);
+  for (j = top; j < bottom; j++) {
+    for (col = from; col < to; col = start + len) {
+      len = xbmNextRun(bitmap + j * byteWidth, col, to, &start);
+      if (!len) start = to;
+      if (start > col) xbmPush(bg, start - col, &runColor, &run);
+      if (len) xbmPush(color, len, &runColor, &run);
     }
   }
+  if (run) pushColor(runColor, run);
+  endWrite();
+}
+
+static int isColorKey(unsigned int c, const unsigned int *keys, int numKeys) {
+  int k;
+
+  for (k = 0; k < numKeys; k++) {
+    if (keys[k] == c) return 1;
+  }
+  return 0;
+}
+
+// Draw a w x h block of RGB565 pixels, stored row by row with rows stride
+// pixels apart, at x, y. The part on screen is streamed in row order through
+// one window. Pixels whose colour is one of the numKeys colours in keys are
+// skipped (left as they are); rows with skipped pixels are sent run by run.
+void drawRGBBitmap(int x, int y, const unsigned int *pixels, int w, int h,
+                   int stride, const unsigned int *keys, int numKeys) {
+  unsigned char line[2 * WIDTH];
+  const unsigned int *row;
+  int from, to, top, bottom;
+  int i, j, start;
+
+  if (!clipImage(x, y, w, h, &from, &to, &top, &bottom)) return;
+
+  // ops recorded so far must reach the panel before this does
+  dlSync();
+
+  startWrite();
+  if (numKeys == 0) {
+    setAddrWindow(x + from, y + top, x + to - 1, y + bottom - 1);
+  }
+  for (j = top; j < bottom; j++) {
+    row = pixels + (long)j * stride;
+    for (i = from; i < to; i++) {
+      line[2*(i-from)]   = row[i] >> 8;
+      line[2*(i-from)+1] = row[i];
+    }
+
+    if (numKeys == 0) {
+      pushPixels(line, to - from);
+      continue;
+    }
+    for (i = from; i < to; ) {
+      if (isColorKey(row[i], keys, numKeys)) {
+        i++;
+        continue;
+      }
+      for (start = i; i < to && !isColorKey(row[i], keys, numKeys); i++);
+      setAddrWindow(x + start, y + j, x + i - 1, y + j);
+      pushPixels(&line[2*(start-from)], i - start);
+    }
+  }
+  endWrite();
+}
+
+// Full-colour image of w x h pixels at the top left of the screen
+void custom_drawBitMap(int w, int h, const unsigned int* colors) {
+  drawRGBBitmap(0, 0, colors, w, h, w, 0, 0);
 }
 
 /*
@@ -449,6 +842,30 @@ void write(unsigned char c) {
 #endif
 }
 */
+// Opaque glyphs are streamed through one window: n characters side by side,
+// 6*size x 8*size each, expanded by glyph_cache.c. The window must lie on
+// screen.
+static void drawGlyphs(int x, int y, const unsigned char *str, int n,
+                       unsigned int color, unsigned int bg, unsigned char size) {
+  // ops recorded so far must reach the panel before this does
+  dlSync();
+
+  startWrite();
+  setAddrWindow(x, y, x + 6*size*n - 1, y + 8*size - 1);
+  glyphStream(str, n, color, bg, size);
+  endWrite();
+}
+
+// Glyphs of the current text size that fit whole inside the clip
+// rectangle from x, y
+static int glyphsOnScreen(int x, int y, unsigned char size) {
+  int cx0, cy0, cx1, cy1;
+
+  getClipRect(&cx0, &cy0, &cx1, &cy1);
+  if (x < cx0 || x > cx1 || y < cy0 || y + 8*size - 1 > cy1) return 0;
+  return (cx1 + 1 - x) / (6*size);
+}
+
 // Draw a character
 void drawChar(int x, int y, unsigned char c,
 			    unsigned int color, unsigned int bg, unsigned char size) {
@@ -456,13 +873,19 @@ void drawChar(int x, int y, unsigned char c,
   unsigned char line;	
   char i;						
   char j;						
+  int x0 = x, y0 = y, x1 = x + 6 * size - 1, y1 = y + 8 * size - 1;
 						
-  if((x >= WIDTH)            || // Clip right
-     (y >= HEIGHT)           || // Clip bottom
-     ((x + 6 * size - 1) < 0) || // Clip left
-     ((y + 8 * size - 1) < 0))   // Clip top
+  // nothing inside the clip rectangle: no SPI traffic at all
+  if (!clipRect(&x0, &y0, &x1, &y1))
+    return;
+
+  if (bg != color && glyphsOnScreen(x, y, size)) {
+    drawGlyphs(x, y, &c, 1, color, bg, size);
     return;
+  }
 
+  // transparent or partly off screen: pixel by pixel
+  startWrite();
   for (i=0; i<6; i++ ) {
     if (i == 5) 
       line = 0x0;
@@ -485,16 +908,90 @@ void drawChar(int x, int y, unsigned char c,
       line >>= 1;
     }
   }
+  endWrite();
+}
+
+// n characters of str on one line from x, y. With an opaque background,
+// the characters that fit on screen go out as one window; the rest are
+// drawn one by one.
+void drawString(int x, int y, const char *str, int n,
+                unsigned int color, unsigned int bg, unsigned char size) {
+  const unsigned char *ptr = (const unsigned char *)str;
+  int run;
+
+  startWrite();
+  while (n > 0) {
+    run = 0;
+    if (bg != color) {
+      run = glyphsOnScreen(x, y, size);
+      if (run > n) run = n;
+    }
+    if (run) {
+      drawGlyphs(x, y, ptr, run, color, bg, size);
+    } else {
+      drawChar(x, y, *ptr, color, bg, size);
+      run = 1;
+    }
+    ptr += run;
+    n -= run;
+    x += 6*size*run;
+  }
+  endWrite();
 }
 
+// Lines end at '\n' and, when wrap is set, before a character that would
+// cross the right edge; the next line starts at column 0.
 void Outstr (char * str) {
 	char * ptr;
+	int n;
 	
 	ptr = str;
+	startWrite();
 	while (*ptr) {
-		drawChar(cursor_x, cursor_y, *ptr++, textcolor, textbgcolor, textsize);
-		cursor_x += 6*textsize;
+		if (*ptr == '\n') {
+			cursor_x = 0;
+			cursor_y += 8*textsize;
+			ptr++;
+			continue;
+		}
+		if (wrap && cursor_x > 0 && cursor_x + 6*textsize > WIDTH) {
+			cursor_x = 0;
+			cursor_y += 8*textsize;
+		}
+
+		// the rest of the line
+		for (n = 0; ptr[n] && ptr[n] != '\n'; n++) {
+			if (wrap && n && cursor_x + 6*textsize*(n+1) > WIDTH) break;
+		}
+		drawString(cursor_x, cursor_y, ptr, n, textcolor, textbgcolor, textsize);
+		ptr += n;
+		cursor_x += 6*textsize*n;
 	}
+	endWrite();
+}
+
+// Size in pixels of str laid out like Outstr from the left edge of a box
+// maxWidth wide, without drawing it
+void measureText(const char *str, unsigned char size, int maxWidth,
+                 int *w, int *h) {
+  int x = 0;
+  int lines = *str ? 1 : 0;
+
+  *w = 0;
+  for (; *str; str++) {
+    if (*str == '\n') {
+      x = 0;
+      lines++;
+      continue;
+    }
+    if (wrap && x > 0 && x + 6*size > maxWidth) {
+      x = 0;
+      lines++;
+    }
+    x += 6*size;
+    if (x > *w) *w = x;
+  }
+  *h = 8*size*lines;
 }
 
 void setCursor(int x, int y) {
@@ -522,6 +1019,10 @@ void setTextColor(unsigned int c, unsigned int b) {
 void setTextWrap(char w) {
   wrap = w;
 }
+
+char getTextWrap(void) {
+  return wrap;
+}
 /*
 unsigned char getRotation(void) {
   return rotation;
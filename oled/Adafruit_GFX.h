@@ -42,20 +42,29 @@
     void drawCircleHelper(int x0, int y0, int r, unsigned char cornername, unsigned int color);
     void fillCircle(int x0, int y0, int r, unsigned int color);
     void fillCircleHelper(int x0, int y0, int r, unsigned char cornername, int delta, unsigned int color);
+    void setCircleTables(char enable);
+    void circleOutlineSpans(int r, unsigned char *lo, unsigned char *hi);
+    void circleFillSpans(int r, unsigned char *hw);
     void drawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, unsigned int color);
     void fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2, unsigned int color);
     void drawRoundRect(int x0, int y0, int w, int h, int radius, unsigned int color);
     void fillRoundRect(int x0, int y0, int w, int h, int radius, unsigned int color);
     void drawBitmap(int x, int y, const unsigned char *bitmap, int w, int h, unsigned int color);
-    // void custom_drawBitMap(int w, int h, const unsigned int* colors);
+    void custom_drawBitMap(int w, int h, const unsigned int* colors);
+    void drawRGBBitmap(int x, int y, const unsigned int *pixels, int w, int h, int stride, const unsigned int *keys, int numKeys);
 //    void drawBitmap(int x, int y, const unsigned char *bitmap, int w, int h, unsigned int color, unsigned int bg);
     void drawXBitmap(int x, int y, const unsigned char *bitmap, int w, int h, unsigned int color);
+    void drawXBitmapOpaque(int x, int y, const unsigned char *bitmap, int w, int h, unsigned int color, unsigned int bg);
+    int xbmNextRun(const unsigned char *row, int from, int to, int *start);
     void drawChar(int x, int y, unsigned char c, unsigned int color, unsigned int bg, unsigned char size);
     void setCursor(int x, int y);
 //    void setTextColor(unsigned int c);
     void setTextColor(unsigned int c, unsigned int bg);
     void setTextSize(unsigned char s);
     void setTextWrap(char w);
+    char getTextWrap(void);
+    void drawString(int x, int y, const char *str, int n, unsigned int color, unsigned int bg, unsigned char size);
+    void measureText(const char *str, unsigned char size, int maxWidth, int *w, int *h);
 //    void setRotation(unsigned char r);
 
 #if ARDUINO >= 100
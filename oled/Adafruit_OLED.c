@@ -1,7 +1,10 @@
 
 // Standard includes
 #include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
 
+#ifndef SSD1351_HOST_SPI
 // Driverlib includes
 #include "hw_types.h"
 #include "hw_memmap.h"
@@ -19,69 +22,1024 @@
 // Common interface includes
 #include "uart_if.h"
 #include "pin_mux_config.h"
+#endif
 
 #include "Adafruit_SSD1351.h"
+#include "display_list.h"
 
+//*****************************************************************************
+//
+// Streaming SPI transport.
+//
+// CS is asserted by the first byte after startWrite() and held until the
+// matching endWrite(), and DC is only toggled when the byte stream switches
+// between command and data. Calls nest, so a primitive that brackets its own
+// transfer can be used inside a larger batch without releasing CS in between.
+// A bracket that never sends a byte (framebuffer drawing) leaves the bus and
+// the asynchronous queue alone.
+//
+// Building with SSD1351_HOST_SPI replaces the driverlib calls with a byte
+// sink (see setHostSpiSink) so the bus traffic can be inspected off-target.
+//
 //*****************************************************************************
 
-void writeCommand(unsigned char c) {
+static unsigned int writeDepth = 0;
+static char csAsserted = 0;
+static int dcState = -1;      // -1 = unknown, 0 = command, 1 = data
+static OledBusStats busStats;
+
+// Controller state mirrored from the byte stream, -1 = unknown. Lets
+// spiAddrWindow() skip whatever the controller already has.
+static char windowCache = 1;
+static int ctlCmd = -1;
+static int ctlArg = 0;
+static int ctlCol0 = -1, ctlCol1 = -1, ctlRow0 = -1, ctlRow1 = -1;
+static int ctlPX = -1, ctlPY = -1;   // RAM write pointer
+static char ctlHalf = 0;             // high byte of a pixel has been sent
+
+static void ctlForget(void) {
+  ctlCmd = -1;
+  ctlCol0 = ctlCol1 = ctlRow0 = ctlRow1 = -1;
+  ctlPX = ctlPY = -1;
+}
 
-//TODO 1
-/* Write a function to send a command byte c to the OLED via
-*  SPI.
-*/
+static void ctlTrackData(unsigned char d) {
+  switch (ctlCmd) {
+  case SSD1351_CMD_SETCOLUMN:
+    if (ctlArg == 0) ctlCol0 = ctlPX = d;
+    else if (ctlArg == 1) ctlCol1 = d;
+    break;
+  case SSD1351_CMD_SETROW:
+    if (ctlArg == 0) ctlRow0 = ctlPY = d;
+    else if (ctlArg == 1) ctlRow1 = d;
+    break;
+  case SSD1351_CMD_WRITERAM:
+    if ((ctlHalf = !ctlHalf)) break;
+    // auto-increment: right, then down, wrapping inside the window
+    if (ctlPX < 0 || ctlPY < 0) break;
+    if (++ctlPX > ctlCol1) {
+      ctlPX = ctlCol0;
+      if (++ctlPY > ctlRow1) ctlPY = ctlRow0;
+    }
+    break;
+  }
+  ctlArg++;
+}
 
-    MAP_SPICSEnable(GSPI_BASE);
+// Non-zero if the next pixel written would land on (x, y) without any
+// window commands.
+static int ctlPointerAt(int x, int y) {
+  return windowCache && ctlCmd == SSD1351_CMD_WRITERAM && !ctlHalf &&
+         ctlPX == x && ctlPY == y;
+}
 
-    //set DC to 0 (cmd)
-    GPIOPinWrite(GPIOA2_BASE, 0x2, 0);
+void setWindowCache(char on) {
+  windowCache = on;
+}
 
-    //set CS to LOW
-    GPIOPinWrite(GPIOA2_BASE, 0x40, 0);
+// Moves the mirrored pointer on by n whole pixels written in bulk
+static void ctlAdvancePixels(unsigned long n) {
+  unsigned long w, pos, area;
 
-    //put data
-    MAP_SPIDataPut(GSPI_BASE, (unsigned long)c);
+  if (ctlCmd != SSD1351_CMD_WRITERAM || ctlHalf || ctlPX < 0 || ctlPY < 0 ||
+      ctlCol1 < ctlCol0 || ctlRow1 < ctlRow0) {
+    ctlForget();
+    return;
+  }
 
-    //get data and store in dummy variable
-    unsigned long dummy;
-    MAP_SPIDataGet(GSPI_BASE, &dummy);
+  w = ctlCol1 - ctlCol0 + 1;
+  area = w * (ctlRow1 - ctlRow0 + 1);
+  pos = ((ctlPY - ctlRow0) * w + (ctlPX - ctlCol0) + n) % area;
+  ctlPX = ctlCol0 + pos % w;
+  ctlPY = ctlRow0 + pos / w;
+}
 
-    //set CS to HI
-    GPIOPinWrite(GPIOA2_BASE, 0x40, 0x40);
+#ifdef SSD1351_HOST_SPI
+static void (*hostSpiSink)(int dc, unsigned char b) = 0;
 
+void setHostSpiSink(void (*sink)(int dc, unsigned char b)) {
+  hostSpiSink = sink;
+}
+#endif
 
-    MAP_SPICSDisable(GSPI_BASE);
+static void spiSetDC(int dc) {
+  if (dc == dcState) return;
 
+#ifndef SSD1351_HOST_SPI
+  GPIOPinWrite(GPIOA2_BASE, 0x2, dc ? 0x2 : 0);
+#endif
+  dcState = dc;
+  busStats.dcToggles++;
 }
+
+//*****************************************************************************
+//
+// SPI configuration and word packing.
+//
+// Commands and short transfers use 8-bit words. Runs of at least
+// SPI_PACK_MIN_PIXELS pixels switch the port to 32-bit words with turbo mode
+// on, so two RGB565 pixels go out per put/get round trip; the next command
+// or short transfer switches back. Reconfiguring drops the forced CS, so it
+// is re-applied when a transfer is open.
+//
 //*****************************************************************************
 
-void writeData(unsigned char c) {
+static unsigned long spiBitRate = 100000;
+static int spiWordBits = 8;
+static char wordPacking = 1;
+static char fifoFill = 1;
+
+static void spiConfigure(int wordBits) {
+#ifndef SSD1351_HOST_SPI
+  MAP_SPIDisable(GSPI_BASE);
+  MAP_SPIConfigSetExpClk(GSPI_BASE, MAP_PRCMPeripheralClockGet(PRCM_GSPI),
+                         spiBitRate, SPI_MODE_MASTER, SPI_SUB_MODE_0,
+                         (SPI_SW_CTRL_CS |
+                         SPI_4PIN_MODE |
+                         (wordBits == 8 ? SPI_TURBO_OFF : SPI_TURBO_ON) |
+                         SPI_CS_ACTIVEHIGH |
+                         (wordBits == 8 ? SPI_WL_8 : SPI_WL_32)));
+  MAP_SPIEnable(GSPI_BASE);
+  if (csAsserted) MAP_SPICSEnable(GSPI_BASE);
+#endif
+  spiWordBits = wordBits;
+}
 
-//TODO 2
-/* Write a function to send a data byte c to the OLED via
-*  SPI.
-*/
+void spiInit(unsigned long bitRate) {
+  spiBitRate = bitRate;
+  spiConfigure(8);
+}
+
+void setSpiBitRate(unsigned long bitRate) {
+  asyncFence();
+  spiBitRate = bitRate;
+  spiConfigure(spiWordBits);
+}
+
+unsigned long getSpiBitRate(void) {
+  return spiBitRate;
+}
+
+void setSpiWordPacking(char on) {
+  wordPacking = on;
+}
+
+void setSpiFifoFill(char on) {
+  fifoFill = on;
+}
+
+static void spiSendWord(unsigned long w) {
+#ifdef SSD1351_HOST_SPI
+  if (hostSpiSink) {
+    hostSpiSink(dcState, w >> 24);
+    hostSpiSink(dcState, w >> 16);
+    hostSpiSink(dcState, w >> 8);
+    hostSpiSink(dcState, w);
+  }
+#else
+  unsigned long dummy;
+
+  MAP_SPIDataPut(GSPI_BASE, w);
+  MAP_SPIDataGet(GSPI_BASE, &dummy);
+#endif
+}
+
+#ifndef SSD1351_FRAMEBUFFER
+// Sends the same 32-bit word n times. With the FIFOs on, the TX FIFO is kept
+// topped up with the replicated colour word and the RX FIFO is drained
+// without waiting on each word, so the CPU only feeds the FIFO instead of
+// doing a put/get round trip per pixel pair.
+static void spiSendRepeat(unsigned long w, unsigned long n) {
+#ifdef SSD1351_HOST_SPI
+  while (n--) spiSendWord(w);
+#else
+  unsigned long sent = 0, received = 0;
+  unsigned long dummy;
+
+  if (!fifoFill) {
+    while (n--) spiSendWord(w);
+    return;
+  }
+
+  MAP_SPIFIFOEnable(GSPI_BASE, SPI_TX_FIFO | SPI_RX_FIFO);
+  while (received < n) {
+    while (sent < n && MAP_SPIDataPutNonBlocking(GSPI_BASE, w)) sent++;
+    while (MAP_SPIDataGetNonBlocking(GSPI_BASE, &dummy)) received++;
+  }
+  MAP_SPIFIFODisable(GSPI_BASE, SPI_TX_FIFO | SPI_RX_FIFO);
+#endif
+}
+#endif
+
+static void spiSend(unsigned char c) {
+  if (spiWordBits != 8) spiConfigure(8);
 
-    MAP_SPICSEnable(GSPI_BASE);
+#ifdef SSD1351_HOST_SPI
+  if (hostSpiSink) hostSpiSink(dcState, c);
+#else
+  unsigned long dummy;
 
-    //set DC to 1 (data)
-    GPIOPinWrite(GPIOA2_BASE, 0x2, 0x2);
+  MAP_SPIDataPut(GSPI_BASE, (unsigned long)c);
+  MAP_SPIDataGet(GSPI_BASE, &dummy);
+#endif
+}
+
+static void spiSelect(void) {
+#ifndef SSD1351_HOST_SPI
+  MAP_SPICSEnable(GSPI_BASE);
+
+  //set CS to LOW
+  GPIOPinWrite(GPIOA2_BASE, 0x40, 0);
+#endif
+  busStats.csCycles++;
+}
+
+static void spiDeselect(void) {
+#ifndef SSD1351_HOST_SPI
+  //set CS to HI
+  GPIOPinWrite(GPIOA2_BASE, 0x40, 0x40);
+
+  MAP_SPICSDisable(GSPI_BASE);
+#endif
+}
+
+void startWrite(void) {
+  writeDepth++;
+}
 
-    //set CS to LOW
-    GPIOPinWrite(GPIOA2_BASE, 0x40, 0);
+void endWrite(void) {
+  if (writeDepth == 0 || --writeDepth) return;
 
-    //put data
-    MAP_SPIDataPut(GSPI_BASE, (unsigned long)c);
+  if (csAsserted) {
+    spiDeselect();
+    csAsserted = 0;
+  }
+}
 
-    //get data and store in dummy variable
-    unsigned long dummy;
-    MAP_SPIDataGet(GSPI_BASE, &dummy);
+static void streamSelect(void) {
+  if (csAsserted) return;
 
-    //set CS to HI
-    GPIOPinWrite(GPIOA2_BASE, 0x40, 0x40);
+  // queued traffic goes out before anything synchronous
+  asyncFence();
+  spiSelect();
+  csAsserted = 1;
+}
 
+void streamCommand(unsigned char c) {
+  streamSelect();
+  spiSetDC(0);
+  spiSend(c);
+  busStats.cmdBytes++;
 
-    MAP_SPICSDisable(GSPI_BASE);
+  ctlCmd = c;
+  ctlArg = 0;
+  ctlHalf = 0;
+}
+
+void streamData(unsigned char d) {
+  streamSelect();
+  spiSetDC(1);
+  spiSend(d);
+  busStats.dataBytes++;
+
+  ctlTrackData(d);
+}
+
+// Streams npixels of big-endian RGB565 from buf, packed two to a word
+static void streamPixels(const unsigned char *buf, unsigned long npixels) {
+  unsigned long n;
+
+  if (wordPacking && npixels >= SPI_PACK_MIN_PIXELS) {
+    streamSelect();
+    spiSetDC(1);
+    if (spiWordBits != 32) spiConfigure(32);
+    for (n = npixels / 2; n; n--) {
+      spiSendWord(((unsigned long)buf[0] << 24) | ((unsigned long)buf[1] << 16) |
+                  ((unsigned long)buf[2] << 8) | buf[3]);
+      buf += 4;
+    }
+    busStats.dataBytes += 2 * (npixels & ~1UL);
+    ctlAdvancePixels(npixels & ~1UL);
+    npixels &= 1;
+  }
+
+  for (n = 2 * npixels; n; n--) streamData(*buf++);
+}
+
+#ifndef SSD1351_FRAMEBUFFER
+// Streams count pixels of one colour, packed two to a word
+static void streamFill(unsigned int color, unsigned long count) {
+  unsigned long w = ((unsigned long)(color & 0xFFFF) << 16) | (color & 0xFFFF);
+
+  if (wordPacking && count >= SPI_PACK_MIN_PIXELS) {
+    streamSelect();
+    spiSetDC(1);
+    if (spiWordBits != 32) spiConfigure(32);
+    spiSendRepeat(w, count / 2);
+    busStats.dataBytes += 2 * (count & ~1UL);
+    ctlAdvancePixels(count & ~1UL);
+    count &= 1;
+  }
+
+  while (count--) {
+    streamData(color >> 8);
+    streamData(color);
+  }
+}
+#endif
+
+//*****************************************************************************
+// Leaves the controller in WRITERAM with the pointer at (x0, y0). An axis
+// whose range is already set and whose pointer already sits at its start is
+// not resent, and nothing at all is sent if the controller is already there.
+// Must be called between startWrite() and endWrite().
+static void spiAddrWindow(int x0, int y0, int x1, int y1) {
+  int sameCol, sameRow;
+
+  x0 &= 0xFF; x1 &= 0xFF;
+  y0 &= 0xFF; y1 &= 0xFF;
+
+  sameCol = windowCache && ctlCol0 == x0 && ctlCol1 == x1 && ctlPX == x0;
+  sameRow = windowCache && ctlRow0 == y0 && ctlRow1 == y1 && ctlPY == y0;
+
+  if (sameCol && sameRow && ctlPointerAt(x0, y0)) return;
+
+  if (!sameCol) {
+    streamCommand(SSD1351_CMD_SETCOLUMN);
+    streamData(x0);
+    streamData(x1);
+  }
+  if (!sameRow) {
+    streamCommand(SSD1351_CMD_SETROW);
+    streamData(y0);
+    streamData(y1);
+  }
+  streamCommand(SSD1351_CMD_WRITERAM);
+}
+
+#ifdef SSD1351_FRAMEBUFFER
+//*****************************************************************************
+//
+// Off-screen framebuffer.
+//
+// Pixels are kept byte-swapped (high byte first in memory) so that any run
+// of the buffer can be handed to the SPI as-is. setAddrWindow()/pushColor()
+// emulate the controller's window and auto-increment against RAM, so every
+// primitive built on them draws off-screen without knowing it.
+//
+// Everything drawn is recorded as a dirty rectangle. Rectangles that overlap
+// or touch are merged; when the list is full the pair that grows the least
+// is merged. flush() only sends the dirty windows.
+//
+// With SSD1351_TILE_HASH the dirty rectangles only nominate 8x8 tiles; each
+// nominated tile is checksummed and sent only if the checksum differs from
+// the one it had at the previous flush, so erase-and-redraw of an unchanged
+// shape costs nothing on the bus. The checksum is a 32-bit FNV-1a over the
+// tile's bytes in order, so the same change in two places of a tile does
+// not cancel out the way it would in a sum or an XOR of its words.
+//
+//*****************************************************************************
+
+unsigned short frameBuffer[SSD1351HEIGHT][SSD1351WIDTH];
+
+static int winX0, winY0, winX1, winY1;
+static int winPX, winPY;
+
+typedef struct {
+  int x0, y0, x1, y1;     // inclusive
+} DirtyRect;
+
+// the whole panel is unknown until the first flush
+static DirtyRect dirty[DIRTY_RECT_MAX] = {{0, 0, SSD1351WIDTH-1, SSD1351HEIGHT-1}};
+static unsigned int numDirty = 1;
+static FlushStats flushStats;
+
+static long rectArea(const DirtyRect *r) {
+  return (long)(r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1);
+}
+
+static void rectUnion(DirtyRect *dst, const DirtyRect *a, const DirtyRect *b) {
+  dst->x0 = a->x0 < b->x0 ? a->x0 : b->x0;
+  dst->y0 = a->y0 < b->y0 ? a->y0 : b->y0;
+  dst->x1 = a->x1 > b->x1 ? a->x1 : b->x1;
+  dst->y1 = a->y1 > b->y1 ? a->y1 : b->y1;
+}
+
+// overlapping or edge/corner adjacent
+static int rectsTouch(const DirtyRect *a, const DirtyRect *b) {
+  return a->x0 <= b->x1 + 1 && b->x0 <= a->x1 + 1 &&
+         a->y0 <= b->y1 + 1 && b->y0 <= a->y1 + 1;
+}
+
+static void removeDirty(unsigned int i) {
+  dirty[i] = dirty[--numDirty];
+}
+
+void markDirty(int x0, int y0, int x1, int y1) {
+  DirtyRect r;
+  unsigned int i, j, best;
+  long cost, bestCost;
+
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 > SSD1351WIDTH-1)  x1 = SSD1351WIDTH-1;
+  if (y1 > SSD1351HEIGHT-1) y1 = SSD1351HEIGHT-1;
+  if (x1 < x0 || y1 < y0) return;
+
+  r.x0 = x0;
+  r.y0 = y0;
+  r.x1 = x1;
+  r.y1 = y1;
+
+  // absorb everything r touches; the union may reach further rects
+  for (i = 0; i < numDirty; ) {
+    if (rectsTouch(&r, &dirty[i])) {
+      rectUnion(&r, &r, &dirty[i]);
+      removeDirty(i);
+      i = 0;
+    } else {
+      i++;
+    }
+  }
+
+  if (numDirty == DIRTY_RECT_MAX) {
+    // out of slots: fold r into whichever rect grows the least
+    best = 0;
+    bestCost = 0x7FFFFFFF;
+    for (j = 0; j < numDirty; j++) {
+      DirtyRect u;
+      rectUnion(&u, &r, &dirty[j]);
+      cost = rectArea(&u) - rectArea(&dirty[j]) - rectArea(&r);
+      if (cost < bestCost) {
+        bestCost = cost;
+        best = j;
+      }
+    }
+    rectUnion(&r, &r, &dirty[best]);
+    removeDirty(best);
+  }
+
+  dirty[numDirty++] = r;
+}
+
+void getFlushStats(FlushStats *stats) {
+  *stats = flushStats;
+}
+
+#ifdef SSD1351_ASYNC_FLUSH
+//*****************************************************************************
+//
+// Overlapped flush.
+//
+// flush() copies the changed windows out of the framebuffer into one of two
+// staging buffers and hands them to the asynchronous transmit queue, then
+// returns so the next frame can be drawn while this one is on the bus. The
+// framebuffer itself is never referenced by the queue, so drawing right after
+// flush() is safe. A staging buffer is only refilled once every segment that
+// points into it has been sent; waiting for that is counted as a stall.
+//
+// Each buffer counts the segments queued from it (written by the main loop
+// only) and the segments sent (written by the SPI interrupt only); it has
+// drained when the two are equal. Neither side ever modifies the other's
+// counter, so no update can be lost to the interrupt.
+//
+//*****************************************************************************
+
+static unsigned char stage[2][FLUSH_STAGE_BYTES];
+static unsigned int stageQueued[2];           // main loop only
+static volatile unsigned int stageSent[2];    // interrupt only
+static int curStage = 0;
+static unsigned long stageFill = 0;
+
+static volatile unsigned long framesQueued = 0;
+static volatile unsigned long framesDone = 0;
+
+// chunk held back so the last one of a frame can carry the frame callback
+static int pendX0, pendY0, pendX1, pendY1;
+static unsigned char *pendBuf = 0;
+static unsigned long pendLen;
+static int pendStage;
+
+// arg is the stageSent entry of the buffer the segment points into
+static void stageDone(void *arg) {
+  (*(volatile unsigned int *)arg)++;
+}
+
+static void frameDone(void *arg) {
+  (*(volatile unsigned int *)arg)++;
+  framesDone++;
+}
+
+static void queuePending(void (*done)(void *arg)) {
+  if (!pendBuf) return;
+
+  asyncQueueWindow(pendX0, pendY0, pendX1, pendY1);
+  asyncQueueData(pendBuf, pendLen, done, (void *)&stageSent[pendStage]);
+  pendBuf = 0;
+}
+
+static void sendBegin(void) {
+  flushStats.framesInFlight = framesQueued - framesDone;
+  if (flushStats.framesInFlight) flushStats.overlappedFlushes++;
+}
+
+static void sendEnd(void) {
+  if (pendBuf) {
+    framesQueued++;
+    queuePending(frameDone);
+  }
+}
+
+static void sendWindow(int x0, int y0, int x1, int y1) {
+  unsigned long rowBytes = 2UL * (x1 - x0 + 1);
+  unsigned long rows;
+  unsigned char *dst;
+  int y;
+
+  while (y0 <= y1) {
+    rows = y1 - y0 + 1;
+    if (rows * rowBytes > FLUSH_STAGE_BYTES - stageFill) {
+      if (rowBytes <= FLUSH_STAGE_BYTES - stageFill) {
+        rows = (FLUSH_STAGE_BYTES - stageFill) / rowBytes;
+      } else {
+        // current stage is full: move to the other once it has drained
+        queuePending(stageDone);
+        curStage ^= 1;
+        stageFill = 0;
+        if (stageSent[curStage] != stageQueued[curStage]) {
+          flushStats.stageStalls++;
+        }
+        while (stageSent[curStage] != stageQueued[curStage]) {
+#ifdef SSD1351_HOST_SPI
+          asyncHostService(1);
+#endif
+        }
+        continue;
+      }
+    }
+
+    queuePending(stageDone);
+
+    dst = &stage[curStage][stageFill];
+    for (y = y0; y < y0 + (int)rows; y++) {
+      memcpy(dst, &frameBuffer[y][x0], rowBytes);
+      dst += rowBytes;
+    }
+
+    pendX0 = x0;
+    pendX1 = x1;
+    pendY0 = y0;
+    pendY1 = y0 + rows - 1;
+    pendBuf = &stage[curStage][stageFill];
+    pendLen = rows * rowBytes;
+    pendStage = curStage;
+    stageQueued[curStage]++;
+
+    stageFill += rows * rowBytes;
+    y0 += rows;
+  }
+}
+
+#else
+static void sendBegin(void) {
+  startWrite();
+}
+
+static void sendEnd(void) {
+  endWrite();
+}
+
+static void sendWindow(int x0, int y0, int x1, int y1) {
+  int y;
+
+  spiAddrWindow(x0, y0, x1, y1);
+  if (x0 == 0 && x1 == SSD1351WIDTH-1) {
+    // full-width rows are contiguous in the framebuffer
+    streamPixels((const unsigned char *)&frameBuffer[y0][0],
+                 (unsigned long)SSD1351WIDTH * (y1 - y0 + 1));
+    return;
+  }
+  for (y = y0; y <= y1; y++) {
+    streamPixels((const unsigned char *)&frameBuffer[y][x0], x1 - x0 + 1);
+  }
+}
+#endif
+
+
+void setAddrWindow(int x0, int y0, int x1, int y1) {
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 > SSD1351WIDTH-1)  x1 = SSD1351WIDTH-1;
+  if (y1 > SSD1351HEIGHT-1) y1 = SSD1351HEIGHT-1;
+
+  markDirty(x0, y0, x1, y1);
+
+  winX0 = winPX = x0;
+  winY0 = winPY = y0;
+  winX1 = x1;
+  winY1 = y1;
+}
+
+void pushColor(unsigned int color, unsigned long count) {
+  unsigned short swapped = FB_SWAP(color);
+  unsigned short *p;
+  unsigned long run;
+
+  if (winX1 < winX0 || winY1 < winY0) return;
+
+  while (count) {
+    run = winX1 - winPX + 1;
+    if (run > count) run = count;
+    count -= run;
+
+    p = &frameBuffer[winPY][winPX];
+    winPX += run;
+    while (run--) *p++ = swapped;
+
+    if (winPX > winX1) {
+      winPX = winX0;
+      if (++winPY > winY1) winPY = winY0;
+    }
+  }
+}
+
+// pixels are already in framebuffer byte order
+void pushPixels(const unsigned char *pixels, unsigned long count) {
+  unsigned long run;
+
+  if (winX1 < winX0 || winY1 < winY0) return;
+
+  while (count) {
+    run = winX1 - winPX + 1;
+    if (run > count) run = count;
+    count -= run;
+
+    memcpy(&frameBuffer[winPY][winPX], pixels, 2 * run);
+    pixels += 2 * run;
+    winPX += run;
+
+    if (winPX > winX1) {
+      winPX = winX0;
+      if (++winPY > winY1) winPY = winY0;
+    }
+  }
+}
+
+#ifdef SSD1351_TILE_HASH
+#define TILE_COLS (SSD1351WIDTH / TILE_SIZE)
+#define TILE_ROWS (SSD1351HEIGHT / TILE_SIZE)
+
+static uint32_t tileHash[TILE_ROWS][TILE_COLS];
+static unsigned char tileValid[TILE_ROWS][TILE_COLS];
+static unsigned char tileState[TILE_ROWS][TILE_COLS];  // per flush, see below
+
+#define TILE_CLEAN    0
+#define TILE_DIRTY    1   // nominated by a dirty rect
+#define TILE_CHANGED  2   // checksum differs, must be sent
+
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+static uint32_t hashTile(int tx, int ty) {
+  const unsigned char *p;
+  uint32_t h = FNV_OFFSET;
+  int row, i;
+
+  for (row = 0; row < TILE_SIZE; row++) {
+    p = (const unsigned char *)&frameBuffer[ty*TILE_SIZE + row][tx*TILE_SIZE];
+    for (i = 0; i < 2 * TILE_SIZE; i++) {
+      h = (h ^ *p++) * FNV_PRIME;
+    }
+  }
+  return h;
+}
+
+void flush(void) {
+  unsigned int i;
+  uint32_t h;
+  int tx, ty, run;
+
+  flushStats.frames++;
+  flushStats.pixelsSent = 0;
+  flushStats.rectsSent = 0;
+  flushStats.tilesHashed = 0;
+  flushStats.tilesSent = 0;
+
+  for (i = 0; i < numDirty; i++) {
+    for (ty = dirty[i].y0 / TILE_SIZE; ty <= dirty[i].y1 / TILE_SIZE; ty++) {
+      for (tx = dirty[i].x0 / TILE_SIZE; tx <= dirty[i].x1 / TILE_SIZE; tx++) {
+        tileState[ty][tx] = TILE_DIRTY;
+      }
+    }
+  }
+  numDirty = 0;
+
+  for (ty = 0; ty < TILE_ROWS; ty++) {
+    for (tx = 0; tx < TILE_COLS; tx++) {
+      if (tileState[ty][tx] != TILE_DIRTY) continue;
+
+      h = hashTile(tx, ty);
+      flushStats.tilesHashed++;
+      if (tileValid[ty][tx] && tileHash[ty][tx] == h) {
+        tileState[ty][tx] = TILE_CLEAN;
+      } else {
+        tileHash[ty][tx] = h;
+        tileValid[ty][tx] = 1;
+        tileState[ty][tx] = TILE_CHANGED;
+      }
+    }
+  }
+
+  sendBegin();
+  for (ty = 0; ty < TILE_ROWS; ty++) {
+    for (tx = 0; tx < TILE_COLS; tx++) {
+      if (tileState[ty][tx] != TILE_CHANGED) continue;
+
+      // coalesce changed neighbours on this tile row into one window
+      for (run = 0; tx + run < TILE_COLS &&
+                    tileState[ty][tx + run] == TILE_CHANGED; run++) {
+        tileState[ty][tx + run] = TILE_CLEAN;
+      }
+
+      sendWindow(tx*TILE_SIZE, ty*TILE_SIZE,
+                 (tx + run)*TILE_SIZE - 1, (ty + 1)*TILE_SIZE - 1);
+
+      flushStats.rectsSent++;
+      flushStats.tilesSent += run;
+      tx += run - 1;
+    }
+  }
+  sendEnd();
+
+  flushStats.pixelsSent = flushStats.tilesSent * TILE_SIZE * TILE_SIZE;
+  flushStats.bytesSaved = 2UL * (flushStats.tilesHashed - flushStats.tilesSent) *
+                          TILE_SIZE * TILE_SIZE;
+}
+
+#else
+void flush(void) {
+  unsigned int i;
+
+  flushStats.frames++;
+  flushStats.pixelsSent = 0;
+  flushStats.rectsSent = numDirty;
+
+  sendBegin();
+  for (i = 0; i < numDirty; i++) {
+    DirtyRect *r = &dirty[i];
+
+    sendWindow(r->x0, r->y0, r->x1, r->y1);
+    flushStats.pixelsSent += rectArea(r);
+  }
+  sendEnd();
+
+  numDirty = 0;
+}
+#endif
+
+#else
+// Must be called between startWrite() and endWrite()
+void setAddrWindow(int x0, int y0, int x1, int y1) {
+  spiAddrWindow(x0, y0, x1, y1);
+}
+
+// Must be called between startWrite() and endWrite()
+void pushColor(unsigned int color, unsigned long count) {
+  streamFill(color, count);
+}
+
+void pushPixels(const unsigned char *pixels, unsigned long count) {
+  streamPixels(pixels, count);
+}
+
+// Sends whatever the display list is holding
+void flush(void) {
+  dlEnd();
+}
+#endif
+
+void getBusStats(OledBusStats *stats) {
+  *stats = busStats;
+}
+
+void resetBusStats(void) {
+  memset(&busStats, 0, sizeof(busStats));
+}
+
+//*****************************************************************************
+//
+// Asynchronous transmit queue.
+//
+// Segments of command or data bytes are queued by the caller and shifted out
+// in the background by the SPI RX-full interrupt: each interrupt means the
+// previous byte has left the shift register, so DC can be switched safely
+// before the next byte is put. Data segments reference the caller's buffer,
+// which must stay untouched until the segment's done callback has run (or
+// until asyncFence() returns). When the queue is full, queueing blocks until
+// the interrupt has freed a slot.
+//
+// In SSD1351_HOST_SPI builds there is no interrupt; asyncHostService() plays
+// the part of the SPI engine and drains a given number of bytes;
+// host_tests/test_async.c checks ordering and back-pressure that way.
+//
+//*****************************************************************************
+
+typedef struct {
+  const unsigned char *buf;   // NULL: bytes come from inl[]
+  unsigned long len;
+  unsigned char inl[2];
+  unsigned char dc;
+  void (*done)(void *arg);
+  void *arg;
+} AsyncSegment;
+
+static AsyncSegment asyncQueue[ASYNC_QUEUE_LEN];
+static volatile unsigned int asyncHead = 0;   // consumer (interrupt)
+static volatile unsigned int asyncTail = 0;   // producer (main loop)
+static volatile unsigned long asyncPos = 0;   // byte offset in head segment
+static volatile char asyncRunning = 0;
+static void (*asyncIdleCallback)(void) = 0;
+
+static void asyncPutNext(void) {
+  AsyncSegment *seg = &asyncQueue[asyncHead];
+  unsigned char b = seg->buf ? seg->buf[asyncPos] : seg->inl[asyncPos];
+
+  // the window cache does not follow queued traffic
+  ctlForget();
+
+  if (spiWordBits != 8) spiConfigure(8);
+  spiSetDC(seg->dc);
+#ifdef SSD1351_HOST_SPI
+  spiSend(b);
+#else
+  MAP_SPIDataPut(GSPI_BASE, (unsigned long)b);
+#endif
+  if (seg->dc) busStats.dataBytes++;
+  else         busStats.cmdBytes++;
+}
+
+// Called once the byte put by asyncPutNext() has been clocked out. Returns
+// non-zero if another byte has been started.
+static int asyncByteDone(void) {
+  AsyncSegment *seg = &asyncQueue[asyncHead];
+
+  if (++asyncPos >= seg->len) {
+    asyncPos = 0;
+    if (seg->done) seg->done(seg->arg);
+    asyncHead = (asyncHead + 1) % ASYNC_QUEUE_LEN;
+  }
+
+  if (asyncHead == asyncTail) {
+    spiDeselect();
+    asyncRunning = 0;
+    if (asyncIdleCallback) asyncIdleCallback();
+    return 0;
+  }
+
+  asyncPutNext();
+  return 1;
+}
+
+#ifdef SSD1351_HOST_SPI
+unsigned long asyncHostService(unsigned long maxBytes) {
+  unsigned long n = 0;
+
+  while (asyncRunning && n < maxBytes) {
+    n++;
+    asyncByteDone();
+  }
+  return n;
+}
+#else
+static void asyncSpiIntHandler(void) {
+  unsigned long status;
+  unsigned long dummy;
+
+  status = MAP_SPIIntStatus(GSPI_BASE, true);
+  MAP_SPIIntClear(GSPI_BASE, status);
+
+  if (!asyncRunning) return;
+
+  MAP_SPIDataGetNonBlocking(GSPI_BASE, &dummy);
+  if (!asyncByteDone()) {
+    MAP_SPIIntDisable(GSPI_BASE, SPI_INT_RX_FULL);
+  }
+}
+#endif
+
+void asyncInit(void) {
+  asyncHead = asyncTail = 0;
+  asyncPos = 0;
+  asyncRunning = 0;
+#ifndef SSD1351_HOST_SPI
+  MAP_SPIIntRegister(GSPI_BASE, asyncSpiIntHandler);
+#endif
+}
+
+void asyncSetIdleCallback(void (*cb)(void)) {
+  asyncIdleCallback = cb;
+}
+
+int asyncBusy(void) {
+  return asyncRunning;
+}
+
+unsigned int asyncPending(void) {
+  return (asyncTail + ASYNC_QUEUE_LEN - asyncHead) % ASYNC_QUEUE_LEN;
+}
+
+void asyncFence(void) {
+  while (asyncRunning) {
+#ifdef SSD1351_HOST_SPI
+    asyncHostService(~0UL);
+#endif
+  }
+}
+
+static void asyncEnqueue(const AsyncSegment *seg) {
+  unsigned int next = (asyncTail + 1) % ASYNC_QUEUE_LEN;
+
+  if (seg->len == 0) {
+    if (seg->done) seg->done(seg->arg);
+    return;
+  }
+
+  // back-pressure: wait for the interrupt to free a slot
+  while (next == asyncHead) {
+#ifdef SSD1351_HOST_SPI
+    asyncHostService(1);
+#endif
+  }
+
+  asyncQueue[asyncTail] = *seg;
+
+#ifndef SSD1351_HOST_SPI
+  MAP_SPIIntDisable(GSPI_BASE, SPI_INT_RX_FULL);
+#endif
+  asyncTail = next;
+  if (!asyncRunning) {
+    asyncRunning = 1;
+    asyncPos = 0;
+    spiSelect();
+    asyncPutNext();
+  }
+#ifndef SSD1351_HOST_SPI
+  MAP_SPIIntEnable(GSPI_BASE, SPI_INT_RX_FULL);
+#endif
+}
+
+void asyncQueueCommand(unsigned char c) {
+  AsyncSegment seg;
+
+  memset(&seg, 0, sizeof(seg));
+  seg.inl[0] = c;
+  seg.len = 1;
+  asyncEnqueue(&seg);
+}
+
+void asyncQueueData(const unsigned char *buf, unsigned long len,
+                    void (*done)(void *arg), void *arg) {
+  AsyncSegment seg;
+
+  seg.buf = buf;
+  seg.len = len;
+  seg.dc = 1;
+  seg.done = done;
+  seg.arg = arg;
+  asyncEnqueue(&seg);
+}
+
+void asyncQueueWindow(int x0, int y0, int x1, int y1) {
+  AsyncSegment seg;
+
+  memset(&seg, 0, sizeof(seg));
+  seg.len = 2;
+  seg.dc = 1;
+
+  asyncQueueCommand(SSD1351_CMD_SETCOLUMN);
+  seg.inl[0] = x0;
+  seg.inl[1] = x1;
+  asyncEnqueue(&seg);
+  asyncQueueCommand(SSD1351_CMD_SETROW);
+  seg.inl[0] = y0;
+  seg.inl[1] = y1;
+  asyncEnqueue(&seg);
+  asyncQueueCommand(SSD1351_CMD_WRITERAM);
+}
+
+//*****************************************************************************
+
+void writeCommand(unsigned char c) {
+  startWrite();
+  streamCommand(c);
+  endWrite();
+}
+//*****************************************************************************
+
+void writeData(unsigned char c) {
+  startWrite();
+  streamData(c);
+  endWrite();
 }
 
 //*****************************************************************************
@@ -95,6 +1053,7 @@ void Adafruit_Init(void){
 *  high or low.
 */
 
+#ifndef SSD1351_HOST_SPI
    Message("Inside init");
 
   volatile unsigned long delay;
@@ -104,6 +1063,9 @@ void Adafruit_Init(void){
   for(delay=0; delay<100; delay=delay+1);// delay minimum 100 ns
 
   GPIOPinWrite(GPIOA3_BASE, 0x10, 0x10);	// RESET = RESET_HIGH
+#endif
+
+  startWrite();
 
 	// Initialization Sequence
   writeCommand(SSD1351_CMD_COMMANDLOCK);  // set command lock
@@ -175,6 +1137,8 @@ void Adafruit_Init(void){
   writeData(0x01);
 
   writeCommand(SSD1351_CMD_DISPLAYON);		//--turn on oled panel
+
+  endWrite();
 }
 
 /***********************************/
@@ -183,15 +1147,9 @@ void goTo(int x, int y) {
   if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT)) return;
 
   // set x and y coordinate
-  writeCommand(SSD1351_CMD_SETCOLUMN);
-  writeData(x);
-  writeData(SSD1351WIDTH-1);
-
-  writeCommand(SSD1351_CMD_SETROW);
-  writeData(y);
-  writeData(SSD1351HEIGHT-1);
-
-  writeCommand(SSD1351_CMD_WRITERAM);
+  startWrite();
+  setAddrWindow(x, y, SSD1351WIDTH-1, SSD1351HEIGHT-1);
+  endWrite();
 }
 
 unsigned int Color565(unsigned char r, unsigned char g, unsigned char b) {
@@ -205,6 +1163,82 @@ unsigned int Color565(unsigned char r, unsigned char g, unsigned char b) {
   return c;
 }
 
+//*****************************************************************************
+//
+// Clip rectangle stack. The current rectangle (inclusive corners) is kept
+// in clipX0..clipY1; pushClipRect() saves it and narrows it to its
+// intersection with the new one, popClipRect() restores it. Primitives
+// reject or trim their shapes against it before any bus traffic.
+//
+//*****************************************************************************
+typedef struct {
+  int x0, y0, x1, y1;
+} ClipRect;
+
+static ClipRect clipStack[CLIP_STACK_DEPTH];
+static int clipDepth = 0;
+static int clipX0 = 0;
+static int clipY0 = 0;
+static int clipX1 = SSD1351WIDTH-1;
+static int clipY1 = SSD1351HEIGHT-1;
+
+// 0 if the stack is full, nothing changes then
+int pushClipRect(int x, int y, int w, int h) {
+  if (clipDepth == CLIP_STACK_DEPTH) return 0;
+
+  clipStack[clipDepth].x0 = clipX0;
+  clipStack[clipDepth].y0 = clipY0;
+  clipStack[clipDepth].x1 = clipX1;
+  clipStack[clipDepth].y1 = clipY1;
+  clipDepth++;
+
+  if (x > clipX0) clipX0 = x;
+  if (y > clipY0) clipY0 = y;
+  if (x + w - 1 < clipX1) clipX1 = x + w - 1;
+  if (y + h - 1 < clipY1) clipY1 = y + h - 1;
+  return 1;
+}
+
+void popClipRect(void) {
+  if (clipDepth == 0) return;
+
+  clipDepth--;
+  clipX0 = clipStack[clipDepth].x0;
+  clipY0 = clipStack[clipDepth].y0;
+  clipX1 = clipStack[clipDepth].x1;
+  clipY1 = clipStack[clipDepth].y1;
+}
+
+void getClipRect(int *x0, int *y0, int *x1, int *y1) {
+  *x0 = clipX0;
+  *y0 = clipY0;
+  *x1 = clipX1;
+  *y1 = clipY1;
+}
+
+// Trims the inclusive rectangle to the clip rectangle; 0 if nothing is left
+int clipRect(int *x0, int *y0, int *x1, int *y1) {
+  if (*x0 < clipX0) *x0 = clipX0;
+  if (*y0 < clipY0) *y0 = clipY0;
+  if (*x1 > clipX1) *x1 = clipX1;
+  if (*y1 > clipY1) *y1 = clipY1;
+  return *x0 <= *x1 && *y0 <= *y1;
+}
+
+// The part of a w x h image drawn at x, y that is inside the clip
+// rectangle, as image columns from..to-1 and rows top..bottom-1
+int clipImage(int x, int y, int w, int h,
+              int *from, int *to, int *top, int *bottom) {
+  int x0 = x, y0 = y, x1 = x + w - 1, y1 = y + h - 1;
+
+  if (w <= 0 || h <= 0 || !clipRect(&x0, &y0, &x1, &y1)) return 0;
+  *from = x0 - x;
+  *to = x1 - x + 1;
+  *top = y0 - y;
+  *bottom = y1 - y + 1;
+  return 1;
+}
+
 void fillScreen(unsigned int fillcolor) {
   fillRect(0, 0, SSD1351WIDTH, SSD1351HEIGHT, fillcolor);
 }
@@ -214,104 +1248,67 @@ void fillScreen(unsigned int fillcolor) {
     @brief  Draws a filled rectangle using HW acceleration
 */
 /**************************************************************************/
-void fillRect(unsigned int x, unsigned int y, unsigned int w, unsigned int h, unsigned int fillcolor)
+void fillRect(int x, int y, int w, int h, unsigned int fillcolor)
 {
-  unsigned int i;
-
-  // Bounds check
-  if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT))
-	return;
+  int x1 = x + w - 1;
+  int y1 = y + h - 1;
 
-  // Y bounds check
-  if (y+h > SSD1351HEIGHT)
-  {
-    h = SSD1351HEIGHT - y - 1;
-  }
+  if (w <= 0 || h <= 0 || !clipRect(&x, &y, &x1, &y1)) return;
 
-  // X bounds check
-  if (x+w > SSD1351WIDTH)
-  {
-    w = SSD1351WIDTH - x - 1;
+#ifndef SSD1351_FRAMEBUFFER
+  if (dlRecording()) {
+    dlRecord(x, y, x1, y1, fillcolor);
+    return;
   }
+#endif
 
-  // set location
-  writeCommand(SSD1351_CMD_SETCOLUMN);
-  writeData(x);
-  writeData(x+w-1);
-  writeCommand(SSD1351_CMD_SETROW);
-  writeData(y);
-  writeData(y+h-1);
-  // fill!
-  writeCommand(SSD1351_CMD_WRITERAM);
-
-  for (i=0; i < w*h; i++) {
-    writeData(fillcolor >> 8);
-    writeData(fillcolor);
-  }
+  // set location and fill!
+  startWrite();
+  setAddrWindow(x, y, x1, y1);
+  pushColor(fillcolor, (unsigned long)(x1-x+1)*(y1-y+1));
+  endWrite();
 }
 
 void drawFastVLine(int x, int y, int h, unsigned int color) {
+  int x1 = x;
+  int y1 = y + h - 1;
 
-  unsigned int i;
-  // Bounds check
-  if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT))
-	return;
+  if (h <= 0 || !clipRect(&x, &y, &x1, &y1)) return;
 
-  // X bounds check
-  if (y+h > SSD1351HEIGHT)
-  {
-    h = SSD1351HEIGHT - y - 1;
+#ifndef SSD1351_FRAMEBUFFER
+  if (dlRecording()) {
+    dlRecord(x, y, x, y1, color);
+    return;
   }
+#endif
 
-  if (h < 0) return;
-
-  // set location
-  writeCommand(SSD1351_CMD_SETCOLUMN);
-  writeData(x);
-  writeData(x);
-  writeCommand(SSD1351_CMD_SETROW);
-  writeData(y);
-  writeData(y+h-1);
-  // fill!
-  writeCommand(SSD1351_CMD_WRITERAM);
-
-  for (i=0; i < h; i++) {
-    writeData(color >> 8);
-    writeData(color);
-  }
+  // set location and fill!
+  startWrite();
+  setAddrWindow(x, y, x, y1);
+  pushColor(color, y1-y+1);
+  endWrite();
 }
 
 
 
 void drawFastHLine(int x, int y, int w, unsigned int color) {
+  int x1 = x + w - 1;
+  int y1 = y;
 
-  unsigned int i;
-  // Bounds check
-  if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT))
-	return;
+  if (w <= 0 || !clipRect(&x, &y, &x1, &y1)) return;
 
-  // X bounds check
-  if (x+w > SSD1351WIDTH)
-  {
-    w = SSD1351WIDTH - x - 1;
+#ifndef SSD1351_FRAMEBUFFER
+  if (dlRecording()) {
+    dlRecord(x, y, x1, y, color);
+    return;
   }
+#endif
 
-  if (w < 0) return;
-
-  // set location
-  writeCommand(SSD1351_CMD_SETCOLUMN);
-  writeData(x);
-  writeData(x+w-1);
-  writeCommand(SSD1351_CMD_SETROW);
-  writeData(y);
-  writeData(y);
-  // fill!
-  writeCommand(SSD1351_CMD_WRITERAM);
-
-  for (i=0; i < w; i++) {
-    writeData(color >> 8);
-    writeData(color);
-  }
+  // set location and fill!
+  startWrite();
+  setAddrWindow(x, y, x1, y);
+  pushColor(color, x1-x+1);
+  endWrite();
 }
 
 
@@ -319,13 +1316,26 @@ void drawFastHLine(int x, int y, int w, unsigned int color) {
 
 void drawPixel(int x, int y, unsigned int color)
 {
-  if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT)) return;
-  if ((x < 0) || (y < 0)) return;
-
-  goTo(x, y);
+  if ((x < clipX0) || (x > clipX1) || (y < clipY0) || (y > clipY1)) return;
+
+#ifdef SSD1351_FRAMEBUFFER
+  frameBuffer[y][x] = FB_SWAP(color);
+  markDirty(x, y, x, y);
+  return;
+#else
+  if (dlRecording()) {
+    dlRecord(x, y, x, y, color);
+    return;
+  }
+#endif
 
-  writeData(color >> 8);
-  writeData(color);
+  startWrite();
+  // the right-hand neighbour of the last pixel needs no window at all
+  if (!ctlPointerAt(x, y)) {
+    setAddrWindow(x, y, SSD1351WIDTH-1, SSD1351HEIGHT-1);
+  }
+  pushColor(color, 1);
+  endWrite();
 }
 
 
@@ -45,6 +45,17 @@
   #error "RGB and BGR can not both be defined for SSD1351_COLORODER."
 #endif
 
+// Define to draw into a 128x128 RGB565 RAM framebuffer (32 KB) that is only
+// sent to the panel by flush(). Leave undefined to draw straight to the panel.
+// #define SSD1351_FRAMEBUFFER
+
+// Framebuffer mode only: send changed 8x8 tiles instead of dirty rectangles
+// #define SSD1351_TILE_HASH
+
+// Framebuffer mode only: flush() queues the frame on the asynchronous
+// transmit queue and returns, so the next frame is drawn while it is sent
+// #define SSD1351_ASYNC_FLUSH
+
 // Timing Delays
 #define SSD1351_DELAYS_HWFILL	    (3)
 #define SSD1351_DELAYS_HWLINE       (1)
@@ -97,12 +108,14 @@ class Adafruit_SSD1351  : public virtual Adafruit_GFX {
 	
   // drawing primitives!
   void drawPixel(int x, int y, unsigned int color);
-  void fillRect(unsigned int x0, unsigned int y0, unsigned int w, unsigned int h, unsigned int color);
+  void fillRect(int x0, int y0, int w, int h, unsigned int color);
   void drawFastHLine(int x, int y, int w, unsigned int color);
   void drawFastVLine(int x, int y, int h, unsigned int color);
   void fillScreen(unsigned int fillcolor);
 
   void invert(char);
+  // framebuffer mode: sends the frame to the panel (no-op otherwise)
+  void flush(void);
   // commands
   void begin(void);
   void goTo(int x, int y);
@@ -114,6 +127,99 @@ class Adafruit_SSD1351  : public virtual Adafruit_GFX {
   void writeData(unsigned char d);
   void writeCommand(unsigned char c);
 
+  // streaming writes: CS stays asserted from startWrite() to endWrite()
+  void startWrite(void);
+  void endWrite(void);
+  void streamCommand(unsigned char c);
+  void streamData(unsigned char d);
+  void setAddrWindow(int x0, int y0, int x1, int y1);
+  void pushColor(unsigned int color, unsigned long count);
+  // count pixels, two bytes each, high byte first
+  void pushPixels(const unsigned char *pixels, unsigned long count);
+  // skip window commands the controller already has (on by default)
+  void setWindowCache(char on);
+
+  // clipping: every primitive draws only inside the top of a stack of
+  // rectangles, each one inside the one below; the screen is the bottom
+  #define CLIP_STACK_DEPTH 8
+  int pushClipRect(int x, int y, int w, int h);
+  void popClipRect(void);
+  void getClipRect(int *x0, int *y0, int *x1, int *y1);
+  int clipRect(int *x0, int *y0, int *x1, int *y1);
+  int clipImage(int x, int y, int w, int h, int *from, int *to, int *top, int *bottom);
+
+  // SPI port: 8-bit words for commands, 32-bit + turbo for long pixel runs
+  #define SPI_PACK_MIN_PIXELS 16
+
+  void spiInit(unsigned long bitRate);
+  void setSpiBitRate(unsigned long bitRate);
+  unsigned long getSpiBitRate(void);
+  void setSpiWordPacking(char on);
+  // constant-colour fills feed the SPI FIFOs without per-word round trips
+  void setSpiFifoFill(char on);
+
+  // bus traffic counters
+  typedef struct {
+    unsigned long csCycles;   // CS assert/release pairs
+    unsigned long dcToggles;  // command <-> data switches
+    unsigned long cmdBytes;
+    unsigned long dataBytes;
+  } OledBusStats;
+
+  void getBusStats(OledBusStats *stats);
+  void resetBusStats(void);
+
+  // asynchronous transmit queue, drained by the SPI interrupt
+  #define ASYNC_QUEUE_LEN 32
+
+  void asyncInit(void);
+  void asyncQueueCommand(unsigned char c);
+  void asyncQueueData(const unsigned char *buf, unsigned long len,
+                      void (*done)(void *arg), void *arg);
+  void asyncQueueWindow(int x0, int y0, int x1, int y1);
+  void asyncSetIdleCallback(void (*cb)(void));
+  void asyncFence(void);
+  int asyncBusy(void);
+  unsigned int asyncPending(void);
+
+#ifdef SSD1351_FRAMEBUFFER
+  // pixels are stored high byte first, ready to be sent as-is
+  #define FB_SWAP(c) ((unsigned short)((((c) >> 8) & 0xFF) | (((c) & 0xFF) << 8)))
+  extern unsigned short frameBuffer[SSD1351HEIGHT][SSD1351WIDTH];
+
+  // regions drawn since the last flush(), merged as they are added
+  #define DIRTY_RECT_MAX 16
+  #define TILE_SIZE 8
+  // two of these stage frames for the asynchronous queue
+  #define FLUSH_STAGE_BYTES 4096
+  void markDirty(int x0, int y0, int x1, int y1);
+
+  typedef struct {
+    unsigned long frames;
+    unsigned long pixelsSent;   // last flush, out of SSD1351WIDTH*SSD1351HEIGHT
+    unsigned int rectsSent;     // last flush
+#ifdef SSD1351_TILE_HASH
+    unsigned int tilesHashed;   // last flush: tiles nominated by dirty rects
+    unsigned int tilesSent;     // last flush: tiles whose checksum changed
+    unsigned long bytesSaved;   // last flush: bytes of unchanged tiles skipped
+#endif
+#ifdef SSD1351_ASYNC_FLUSH
+    unsigned long framesInFlight;     // earlier frames still on the bus at flush
+    unsigned long overlappedFlushes;  // flushes that found a frame in flight
+    unsigned long stageStalls;        // waits for a staging buffer to drain
+#endif
+  } FlushStats;
+
+  void getFlushStats(FlushStats *stats);
+#endif
+
+#ifdef SSD1351_HOST_SPI
+  // host builds: receives every byte instead of the SPI peripheral
+  void setHostSpiSink(void (*sink)(int dc, unsigned char b));
+  // host builds: stands in for the SPI interrupt, returns bytes drained
+  unsigned long asyncHostService(unsigned long maxBytes);
+#endif
+
 
   void writeData_unsafe(unsigned int d);
 
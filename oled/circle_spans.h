@@ -0,0 +1,36 @@
+#ifndef CIRCLE_SPANS_H
+#define CIRCLE_SPANS_H
+
+// Row spans of the circles the game draws: the tank (r=6), projectiles (r=3)
+// and targets (r=4). Generated offline from the midpoint loops in drawCircle()
+// and fillCircle(); host_tests/test_circles.c checks every radius against
+// them. Entry dy describes rows y0 +/- dy: the outline covers x offsets
+// lo..hi on each side (one run through the centre when lo is 0), the fill
+// covers -hw..hw.
+
+typedef struct {
+  unsigned char r;
+  const unsigned char *lo;
+  const unsigned char *hi;
+  const unsigned char *hw;
+} CircleSpans;
+
+static const unsigned char circle3_lo[] = {3, 3, 2, 0};
+static const unsigned char circle3_hi[] = {3, 3, 2, 1};
+static const unsigned char circle3_hw[] = {3, 3, 2, 1};
+
+static const unsigned char circle4_lo[] = {4, 4, 3, 2, 0};
+static const unsigned char circle4_hi[] = {4, 4, 3, 3, 1};
+static const unsigned char circle4_hw[] = {4, 4, 3, 3, 1};
+
+static const unsigned char circle6_lo[] = {6, 6, 6, 5, 4, 3, 0};
+static const unsigned char circle6_hi[] = {6, 6, 6, 5, 4, 3, 2};
+static const unsigned char circle6_hw[] = {6, 6, 6, 5, 4, 3, 2};
+
+static const CircleSpans circleSpans[] = {
+  {3, circle3_lo, circle3_hi, circle3_hw},
+  {4, circle4_lo, circle4_hi, circle4_hw},
+  {6, circle6_lo, circle6_hi, circle6_hw},
+};
+
+#endif // CIRCLE_SPANS_H
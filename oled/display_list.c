@@ -0,0 +1,166 @@
+/*
+ * display_list.c
+ *
+ * drawPixel, drawFastHLine, drawFastVLine and fillRect record a fill op here
+ * instead of writing to the panel while a list is open. dlEnd() then:
+ *
+ *  - drops pixels that a later op in the same frame covers,
+ *  - moves the surviving pixels after the other ops (nothing later covers
+ *    them, so this cannot change the image) and sorts them into raster order,
+ *  - sends horizontally adjacent pixels as one window using the
+ *    controller's auto-increment.
+ *
+ * Windows go through setAddrWindow(), whose window cache skips SETCOLUMN/
+ * SETROW when the controller already has that range.
+ *
+ * Only meaningful when drawing straight to the panel; in framebuffer mode
+ * the primitives never record.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "Adafruit_SSD1351.h"
+#include "display_list.h"
+
+typedef struct {
+  unsigned char x0, y0, x1, y1;   // inclusive
+  unsigned short color;
+} DlOp;
+
+static DlOp ops[DL_MAX_OPS];
+static unsigned int numOps = 0;
+static char recording = 0;
+static DisplayListStats dlStats;
+
+#define OP_IS_PIXEL(o) ((o)->x0 == (o)->x1 && (o)->y0 == (o)->y1)
+// SETCOLUMN + 2, SETROW + 2, WRITERAM
+#define WINDOW_BYTES 7
+
+static int opCovers(const DlOp *o, int x, int y) {
+  return x >= o->x0 && x <= o->x1 && y >= o->y0 && y <= o->y1;
+}
+
+static int comparePixels(const void *a, const void *b) {
+  const DlOp *pa = (const DlOp *)a;
+  const DlOp *pb = (const DlOp *)b;
+
+  if (pa->y0 != pb->y0) return pa->y0 - pb->y0;
+  return pa->x0 - pb->x0;
+}
+
+static void sendList(void) {
+  OledBusStats before, after;
+  unsigned int i, j, n, numPixels;
+  DlOp tmp;
+
+  if (numOps == 0) return;
+
+  // drop pixels covered by a later op
+  n = 0;
+  for (i = 0; i < numOps; i++) {
+    if (OP_IS_PIXEL(&ops[i])) {
+      for (j = i + 1; j < numOps; j++) {
+        if (opCovers(&ops[j], ops[i].x0, ops[i].y0)) break;
+      }
+      if (j < numOps) {
+        dlStats.opsDropped++;
+        continue;
+      }
+    }
+    ops[n++] = ops[i];
+  }
+
+  // stable partition: larger ops first, surviving pixels after them
+  numPixels = 0;
+  for (i = 0; i < n; i++) {
+    if (!OP_IS_PIXEL(&ops[i])) {
+      tmp = ops[i];
+      memmove(&ops[i - numPixels + 1], &ops[i - numPixels],
+              numPixels * sizeof(DlOp));
+      ops[i - numPixels] = tmp;
+    } else {
+      numPixels++;
+    }
+  }
+  qsort(&ops[n - numPixels], numPixels, sizeof(DlOp), comparePixels);
+
+  getBusStats(&before);
+  startWrite();
+  for (i = 0; i < n - numPixels; i++) {
+    setAddrWindow(ops[i].x0, ops[i].y0, ops[i].x1, ops[i].y1);
+    pushColor(ops[i].color,
+              (unsigned long)(ops[i].x1 - ops[i].x0 + 1) * (ops[i].y1 - ops[i].y0 + 1));
+  }
+  for (; i < n; i = j) {
+    // run of horizontally adjacent pixels, colours may differ
+    for (j = i + 1; j < n && ops[j].y0 == ops[i].y0 &&
+                    ops[j].x0 == ops[j - 1].x0 + 1; j++);
+
+    setAddrWindow(ops[i].x0, ops[i].y0, ops[j - 1].x0, ops[i].y0);
+    for (; i < j; i++) {
+      pushColor(ops[i].color, 1);
+    }
+  }
+  endWrite();
+  getBusStats(&after);
+
+  dlStats.bytesAfter += (after.cmdBytes + after.dataBytes) -
+                        (before.cmdBytes + before.dataBytes);
+  numOps = 0;
+}
+
+void dlBegin(void) {
+  memset(&dlStats, 0, sizeof(dlStats));
+  numOps = 0;
+  recording = 1;
+}
+
+void dlEnd(void) {
+  if (!recording) return;
+
+  // sending goes through the primitives' own low level, not the list
+  recording = 0;
+  sendList();
+}
+
+// Sends what has been recorded so far and keeps recording. Called before
+// writing to the panel directly, so that the write lands after those ops.
+void dlSync(void) {
+  if (!recording) return;
+
+  recording = 0;
+  sendList();
+  recording = 1;
+}
+
+int dlRecording(void) {
+  return recording;
+}
+
+void dlRecord(int x0, int y0, int x1, int y1, unsigned int color) {
+  DlOp *o;
+
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 > SSD1351WIDTH-1)  x1 = SSD1351WIDTH-1;
+  if (y1 > SSD1351HEIGHT-1) y1 = SSD1351HEIGHT-1;
+  if (x1 < x0 || y1 < y0) return;
+
+  if (numOps == DL_MAX_OPS) dlSync();
+
+  o = &ops[numOps++];
+  o->x0 = x0;
+  o->y0 = y0;
+  o->x1 = x1;
+  o->y1 = y1;
+  o->color = color;
+
+  dlStats.ops++;
+  dlStats.bytesBefore += WINDOW_BYTES +
+                         2UL * (x1 - x0 + 1) * (y1 - y0 + 1);
+}
+
+void getDisplayListStats(DisplayListStats *stats) {
+  *stats = dlStats;
+}
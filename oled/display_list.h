@@ -0,0 +1,28 @@
+/*
+ * display_list.h
+ *
+ * Records a frame's constant-colour fills (pixels, lines, rectangles) while
+ * drawing straight to the panel, then optimizes and sends them in dlEnd().
+ */
+
+#ifndef OLED_DISPLAY_LIST_H_
+#define OLED_DISPLAY_LIST_H_
+
+// Ops held before the list is sent early to make room
+#define DL_MAX_OPS 512
+
+typedef struct {
+  unsigned long ops;          // ops recorded
+  unsigned long opsDropped;   // pixels overwritten later in the same frame
+  unsigned long bytesBefore;  // bus bytes the ops would cost one by one
+  unsigned long bytesAfter;   // bus bytes actually sent
+} DisplayListStats;
+
+void dlBegin(void);
+void dlEnd(void);
+void dlSync(void);
+int dlRecording(void);
+void dlRecord(int x0, int y0, int x1, int y1, unsigned int color);
+void getDisplayListStats(DisplayListStats *stats);
+
+#endif /* OLED_DISPLAY_LIST_H_ */
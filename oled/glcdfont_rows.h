@@ -0,0 +1,266 @@
+#ifndef FONT5X7_ROWS_H
+#define FONT5X7_ROWS_H
+
+// The 5x7 font of glcdfont.h transposed to rows: 8 bytes per character, one
+// per pixel row from the top, bit i set for column i. Generated offline from
+// font[]; regenerate if that table changes. host_tests/test_font.c checks
+// the two tables agree.
+
+static const unsigned char fontRows[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x0E, 0x1F, 0x15, 0x1F, 0x1B, 0x11, 0x0E, 0x00,
+	0x0E, 0x1F, 0x15, 0x1F, 0x11, 0x1B, 0x0E, 0x00,
+	0x00, 0x0A, 0x1F, 0x1F, 0x1F, 0x0E, 0x04, 0x00,
+	0x00, 0x04, 0x0E, 0x1F, 0x1F, 0x0E, 0x04, 0x00,
+	0x0E, 0x0A, 0x1F, 0x15, 0x1F, 0x04, 0x0E, 0x00,
+	0x04, 0x0E, 0x1F, 0x1F, 0x1F, 0x04, 0x0E, 0x00,
+	0x00, 0x00, 0x04, 0x0E, 0x0E, 0x04, 0x00, 0x00,
+	0x1F, 0x1F, 0x1B, 0x11, 0x11, 0x1B, 0x1F, 0x1F,
+	0x00, 0x00, 0x04, 0x0A, 0x0A, 0x04, 0x00, 0x00,
+	0x1F, 0x1F, 0x1B, 0x15, 0x15, 0x1B, 0x1F, 0x1F,
+	0x00, 0x1C, 0x18, 0x16, 0x05, 0x05, 0x02, 0x00,
+	0x0E, 0x11, 0x11, 0x0E, 0x04, 0x1F, 0x04, 0x00,
+	0x1E, 0x12, 0x1E, 0x02, 0x02, 0x02, 0x03, 0x00,
+	0x1E, 0x12, 0x1E, 0x12, 0x12, 0x1A, 0x03, 0x00,
+	0x04, 0x15, 0x0E, 0x1B, 0x1B, 0x0E, 0x15, 0x04,
+	0x01, 0x03, 0x0F, 0x1F, 0x0F, 0x03, 0x01, 0x00,
+	0x10, 0x18, 0x1E, 0x1F, 0x1E, 0x18, 0x10, 0x00,
+	0x04, 0x0E, 0x15, 0x04, 0x15, 0x0E, 0x04, 0x00,
+	0x1B, 0x1B, 0x1B, 0x1B, 0x1B, 0x00, 0x1B, 0x00,
+	0x1E, 0x15, 0x15, 0x16, 0x14, 0x14, 0x14, 0x00,
+	0x0C, 0x12, 0x0A, 0x14, 0x08, 0x12, 0x12, 0x0C,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x00,
+	0x04, 0x0E, 0x15, 0x04, 0x15, 0x0E, 0x04, 0x1F,
+	0x00, 0x04, 0x0E, 0x15, 0x04, 0x04, 0x04, 0x00,
+	0x00, 0x04, 0x04, 0x04, 0x15, 0x0E, 0x04, 0x00,
+	0x00, 0x04, 0x08, 0x1F, 0x08, 0x04, 0x00, 0x00,
+	0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00, 0x00,
+	0x00, 0x01, 0x01, 0x01, 0x1F, 0x00, 0x00, 0x00,
+	0x00, 0x0A, 0x1F, 0x1F, 0x0A, 0x00, 0x00, 0x00,
+	0x00, 0x04, 0x04, 0x0E, 0x1F, 0x1F, 0x00, 0x00,
+	0x00, 0x1F, 0x1F, 0x0E, 0x04, 0x04, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00,
+	0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A, 0x00,
+	0x04, 0x1E, 0x05, 0x0E, 0x14, 0x0F, 0x04, 0x00,
+	0x03, 0x13, 0x08, 0x04, 0x02, 0x19, 0x18, 0x00,
+	0x02, 0x05, 0x05, 0x02, 0x15, 0x09, 0x16, 0x00,
+	0x0C, 0x0C, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00,
+	0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, 0x00,
+	0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, 0x00,
+	0x04, 0x15, 0x0E, 0x1F, 0x0E, 0x15, 0x04, 0x00,
+	0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x04, 0x02,
+	0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00,
+	0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00,
+	0x0E, 0x11, 0x19, 0x15, 0x13, 0x11, 0x0E, 0x00,
+	0x04, 0x06, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00,
+	0x0E, 0x11, 0x10, 0x0E, 0x01, 0x01, 0x1F, 0x00,
+	0x1F, 0x10, 0x08, 0x0C, 0x10, 0x11, 0x0E, 0x00,
+	0x08, 0x0C, 0x0A, 0x09, 0x1F, 0x08, 0x08, 0x00,
+	0x1F, 0x01, 0x0F, 0x10, 0x10, 0x11, 0x0E, 0x00,
+	0x1C, 0x02, 0x01, 0x0F, 0x11, 0x11, 0x0E, 0x00,
+	0x1F, 0x10, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00,
+	0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+	0x0E, 0x11, 0x11, 0x1E, 0x10, 0x08, 0x07, 0x00,
+	0x00, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x04, 0x00, 0x04, 0x04, 0x02, 0x00,
+	0x10, 0x08, 0x04, 0x02, 0x04, 0x08, 0x10, 0x00,
+	0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00,
+	0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00,
+	0x0E, 0x11, 0x10, 0x0C, 0x04, 0x00, 0x04, 0x00,
+	0x0E, 0x11, 0x15, 0x1D, 0x0D, 0x01, 0x1E, 0x00,
+	0x04, 0x0A, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x00,
+	0x0F, 0x11, 0x11, 0x0F, 0x11, 0x11, 0x0F, 0x00,
+	0x0E, 0x11, 0x01, 0x01, 0x01, 0x11, 0x0E, 0x00,
+	0x0F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0F, 0x00,
+	0x1F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x1F, 0x00,
+	0x1F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x01, 0x00,
+	0x1E, 0x11, 0x01, 0x01, 0x19, 0x11, 0x1E, 0x00,
+	0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00,
+	0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00,
+	0x1C, 0x08, 0x08, 0x08, 0x08, 0x09, 0x06, 0x00,
+	0x11, 0x09, 0x05, 0x03, 0x05, 0x09, 0x11, 0x00,
+	0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x1F, 0x00,
+	0x11, 0x1B, 0x15, 0x15, 0x15, 0x11, 0x11, 0x00,
+	0x11, 0x11, 0x13, 0x15, 0x19, 0x11, 0x11, 0x00,
+	0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00,
+	0x0F, 0x11, 0x11, 0x0F, 0x01, 0x01, 0x01, 0x00,
+	0x0E, 0x11, 0x11, 0x11, 0x15, 0x09, 0x16, 0x00,
+	0x0F, 0x11, 0x11, 0x0F, 0x05, 0x09, 0x11, 0x00,
+	0x0E, 0x11, 0x01, 0x0E, 0x10, 0x11, 0x0E, 0x00,
+	0x1F, 0x15, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00,
+	0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00,
+	0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00,
+	0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A, 0x00,
+	0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11, 0x00,
+	0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04, 0x00,
+	0x1F, 0x10, 0x08, 0x0E, 0x02, 0x01, 0x1F, 0x00,
+	0x1E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x1E, 0x00,
+	0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, 0x00,
+	0x1E, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1E, 0x00,
+	0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x00,
+	0x06, 0x06, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+	0x01, 0x01, 0x0D, 0x13, 0x11, 0x13, 0x0D, 0x00,
+	0x00, 0x00, 0x0E, 0x11, 0x01, 0x11, 0x0E, 0x00,
+	0x10, 0x10, 0x16, 0x19, 0x11, 0x19, 0x16, 0x00,
+	0x00, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x0E, 0x00,
+	0x08, 0x14, 0x04, 0x0E, 0x04, 0x04, 0x04, 0x00,
+	0x00, 0x00, 0x0E, 0x19, 0x19, 0x16, 0x10, 0x0E,
+	0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x11, 0x00,
+	0x04, 0x00, 0x06, 0x04, 0x04, 0x04, 0x0E, 0x00,
+	0x08, 0x00, 0x08, 0x08, 0x08, 0x09, 0x06, 0x00,
+	0x01, 0x01, 0x09, 0x05, 0x03, 0x05, 0x09, 0x00,
+	0x06, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00,
+	0x00, 0x00, 0x0B, 0x15, 0x15, 0x15, 0x15, 0x00,
+	0x00, 0x00, 0x0D, 0x13, 0x11, 0x11, 0x11, 0x00,
+	0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00,
+	0x00, 0x00, 0x0D, 0x13, 0x13, 0x0D, 0x01, 0x01,
+	0x00, 0x00, 0x16, 0x19, 0x19, 0x16, 0x10, 0x10,
+	0x00, 0x00, 0x0D, 0x13, 0x01, 0x01, 0x01, 0x00,
+	0x00, 0x00, 0x1E, 0x01, 0x0E, 0x10, 0x0F, 0x00,
+	0x04, 0x04, 0x1F, 0x04, 0x04, 0x14, 0x08, 0x00,
+	0x00, 0x00, 0x11, 0x11, 0x11, 0x19, 0x16, 0x00,
+	0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00,
+	0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A, 0x00,
+	0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00,
+	0x00, 0x00, 0x11, 0x11, 0x1E, 0x10, 0x11, 0x0E,
+	0x00, 0x00, 0x1F, 0x08, 0x04, 0x02, 0x1F, 0x00,
+	0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08, 0x00,
+	0x04, 0x04, 0x04, 0x00, 0x04, 0x04, 0x04, 0x00,
+	0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02, 0x00,
+	0x02, 0x15, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x04, 0x0E, 0x1B, 0x11, 0x11, 0x1F, 0x00, 0x00,
+	0x0E, 0x11, 0x01, 0x01, 0x11, 0x0E, 0x08, 0x06,
+	0x00, 0x11, 0x00, 0x11, 0x11, 0x19, 0x16, 0x00,
+	0x18, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x1E, 0x00,
+	0x1F, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+	0x00, 0x11, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+	0x03, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+	0x0C, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+	0x00, 0x1E, 0x03, 0x03, 0x1E, 0x08, 0x0C, 0x00,
+	0x1F, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x1E, 0x00,
+	0x11, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x1E, 0x00,
+	0x03, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x1E, 0x00,
+	0x14, 0x00, 0x0C, 0x08, 0x08, 0x08, 0x1C, 0x00,
+	0x0C, 0x12, 0x0C, 0x08, 0x08, 0x08, 0x1C, 0x00,
+	0x06, 0x00, 0x0C, 0x08, 0x08, 0x08, 0x1C, 0x00,
+	0x15, 0x0A, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x00,
+	0x04, 0x00, 0x04, 0x0A, 0x11, 0x1F, 0x11, 0x11,
+	0x0C, 0x00, 0x0F, 0x01, 0x07, 0x01, 0x0F, 0x00,
+	0x00, 0x00, 0x1E, 0x08, 0x1E, 0x09, 0x1E, 0x00,
+	0x1C, 0x0A, 0x09, 0x1F, 0x09, 0x09, 0x19, 0x00,
+	0x0E, 0x11, 0x00, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+	0x00, 0x11, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00,
+	0x00, 0x03, 0x00, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+	0x0E, 0x11, 0x00, 0x11, 0x11, 0x19, 0x16, 0x00,
+	0x00, 0x03, 0x00, 0x11, 0x11, 0x19, 0x16, 0x00,
+	0x12, 0x00, 0x12, 0x12, 0x12, 0x1C, 0x10, 0x0E,
+	0x11, 0x0E, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00,
+	0x11, 0x00, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00,
+	0x04, 0x04, 0x1F, 0x05, 0x05, 0x1F, 0x04, 0x04,
+	0x0C, 0x1A, 0x12, 0x07, 0x02, 0x12, 0x1F, 0x00,
+	0x1B, 0x1B, 0x0E, 0x1F, 0x04, 0x1F, 0x04, 0x04,
+	0x07, 0x09, 0x09, 0x07, 0x09, 0x1D, 0x09, 0x09,
+	0x18, 0x14, 0x04, 0x0E, 0x04, 0x04, 0x05, 0x03,
+	0x18, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+	0x18, 0x00, 0x0C, 0x08, 0x08, 0x08, 0x1C, 0x00,
+	0x00, 0x18, 0x00, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+	0x00, 0x18, 0x00, 0x11, 0x11, 0x19, 0x16, 0x00,
+	0x00, 0x1E, 0x00, 0x0E, 0x12, 0x12, 0x12, 0x00,
+	0x1F, 0x00, 0x13, 0x17, 0x1D, 0x19, 0x11, 0x00,
+	0x0E, 0x09, 0x09, 0x1E, 0x00, 0x1F, 0x00, 0x00,
+	0x0E, 0x11, 0x11, 0x0E, 0x00, 0x1F, 0x00, 0x00,
+	0x04, 0x00, 0x04, 0x06, 0x01, 0x11, 0x0E, 0x00,
+	0x00, 0x00, 0x00, 0x1F, 0x01, 0x01, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x1F, 0x10, 0x10, 0x00, 0x00,
+	0x01, 0x11, 0x09, 0x1D, 0x12, 0x19, 0x04, 0x1C,
+	0x01, 0x11, 0x09, 0x15, 0x1A, 0x1D, 0x10, 0x10,
+	0x04, 0x04, 0x00, 0x04, 0x04, 0x04, 0x04, 0x00,
+	0x00, 0x14, 0x0A, 0x05, 0x0A, 0x14, 0x00, 0x00,
+	0x00, 0x05, 0x0A, 0x14, 0x0A, 0x05, 0x00, 0x00,
+	0x04, 0x11, 0x04, 0x11, 0x04, 0x11, 0x04, 0x11,
+	0x0A, 0x15, 0x0A, 0x15, 0x0A, 0x15, 0x0A, 0x15,
+	0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+	0x08, 0x08, 0x08, 0x08, 0x0F, 0x08, 0x08, 0x08,
+	0x08, 0x08, 0x0F, 0x08, 0x0F, 0x08, 0x08, 0x08,
+	0x14, 0x14, 0x14, 0x14, 0x17, 0x14, 0x14, 0x14,
+	0x00, 0x00, 0x00, 0x00, 0x1F, 0x14, 0x14, 0x14,
+	0x00, 0x00, 0x0F, 0x08, 0x0F, 0x08, 0x08, 0x08,
+	0x14, 0x14, 0x17, 0x10, 0x17, 0x14, 0x14, 0x14,
+	0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+	0x00, 0x00, 0x1F, 0x10, 0x17, 0x14, 0x14, 0x14,
+	0x14, 0x14, 0x17, 0x10, 0x1F, 0x00, 0x00, 0x00,
+	0x14, 0x14, 0x14, 0x14, 0x1F, 0x00, 0x00, 0x00,
+	0x08, 0x08, 0x0F, 0x08, 0x0F, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x0F, 0x08, 0x08, 0x08,
+	0x08, 0x08, 0x08, 0x08, 0x18, 0x00, 0x00, 0x00,
+	0x08, 0x08, 0x08, 0x08, 0x1F, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x1F, 0x08, 0x08, 0x08,
+	0x08, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x08,
+	0x00, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00,
+	0x08, 0x08, 0x08, 0x08, 0x1F, 0x08, 0x08, 0x08,
+	0x08, 0x08, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08,
+	0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+	0x14, 0x14, 0x14, 0x04, 0x1C, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x1C, 0x04, 0x14, 0x14, 0x14, 0x14,
+	0x14, 0x14, 0x17, 0x00, 0x1F, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x1F, 0x00, 0x17, 0x14, 0x14, 0x14,
+	0x14, 0x14, 0x14, 0x04, 0x14, 0x14, 0x14, 0x14,
+	0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00,
+	0x14, 0x14, 0x17, 0x00, 0x17, 0x14, 0x14, 0x14,
+	0x08, 0x08, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00,
+	0x14, 0x14, 0x14, 0x14, 0x1F, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x1F, 0x00, 0x1F, 0x08, 0x08, 0x08,
+	0x00, 0x00, 0x00, 0x00, 0x1F, 0x14, 0x14, 0x14,
+	0x14, 0x14, 0x14, 0x14, 0x1C, 0x00, 0x00, 0x00,
+	0x08, 0x08, 0x18, 0x08, 0x18, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08,
+	0x00, 0x00, 0x00, 0x00, 0x1C, 0x14, 0x14, 0x14,
+	0x14, 0x14, 0x14, 0x14, 0x1F, 0x14, 0x14, 0x14,
+	0x08, 0x08, 0x1F, 0x08, 0x1F, 0x08, 0x08, 0x08,
+	0x08, 0x08, 0x08, 0x08, 0x0F, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x18, 0x08, 0x08, 0x08,
+	0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F,
+	0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F,
+	0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+	0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+	0x1F, 0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x16, 0x09, 0x09, 0x09, 0x16, 0x00,
+	0x00, 0x0E, 0x11, 0x0F, 0x11, 0x11, 0x0F, 0x01,
+	0x00, 0x1F, 0x19, 0x01, 0x01, 0x01, 0x01, 0x00,
+	0x00, 0x1F, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x00,
+	0x1F, 0x11, 0x02, 0x04, 0x02, 0x11, 0x1F, 0x00,
+	0x00, 0x00, 0x1E, 0x09, 0x09, 0x09, 0x06, 0x00,
+	0x00, 0x0A, 0x0A, 0x0A, 0x0A, 0x16, 0x03, 0x00,
+	0x00, 0x1F, 0x05, 0x04, 0x04, 0x04, 0x04, 0x00,
+	0x1F, 0x04, 0x0E, 0x11, 0x11, 0x0E, 0x04, 0x1F,
+	0x04, 0x0A, 0x11, 0x1F, 0x11, 0x0A, 0x04, 0x00,
+	0x04, 0x0A, 0x11, 0x11, 0x0A, 0x0A, 0x1B, 0x00,
+	0x0C, 0x02, 0x0C, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+	0x00, 0x00, 0x00, 0x0E, 0x15, 0x15, 0x0E, 0x00,
+	0x10, 0x0E, 0x19, 0x15, 0x15, 0x13, 0x0E, 0x01,
+	0x0E, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x0E, 0x00,
+	0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x00,
+	0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00,
+	0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, 0x1F, 0x00,
+	0x02, 0x04, 0x08, 0x04, 0x02, 0x00, 0x1F, 0x00,
+	0x08, 0x04, 0x02, 0x04, 0x08, 0x00, 0x1F, 0x00,
+	0x1C, 0x14, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+	0x04, 0x04, 0x04, 0x04, 0x04, 0x05, 0x05, 0x07,
+	0x0C, 0x0C, 0x00, 0x1F, 0x00, 0x0C, 0x0C, 0x00,
+	0x00, 0x17, 0x1D, 0x00, 0x17, 0x1D, 0x00, 0x00,
+	0x0E, 0x1B, 0x1B, 0x0E, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00,
+	0x1C, 0x04, 0x04, 0x04, 0x05, 0x05, 0x06, 0x04,
+	0x0E, 0x12, 0x12, 0x12, 0x12, 0x00, 0x00, 0x00,
+	0x0E, 0x18, 0x0C, 0x06, 0x1E, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x1E, 0x1E, 0x1E, 0x1E, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+#endif // FONT5X7_ROWS_H
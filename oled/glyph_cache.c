@@ -0,0 +1,179 @@
+/*
+ * glyph_cache.c
+ *
+ * glyphStream() fills a window the caller has opened with n opaque glyphs
+ * side by side. Each pixel row of the text is assembled in a line buffer
+ * and sent with one pushPixels(), size times over.
+ *
+ * A glyph is expanded from the row-major fontRows[] table once, at its
+ * width but not its height (rows are repeated while streaming), and kept in
+ * a pool of GLYPH_CACHE_BYTES. Lookups are keyed by character, colours and
+ * size. When a new glyph does not fit, the least recently used glyphs are
+ * evicted and the pool is compacted. Glyphs of the string being drawn are
+ * never evicted for each other; a glyph that cannot be placed is expanded
+ * into the line buffer directly, as is everything when the cache is off.
+ */
+
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+#include "glcdfont_rows.h"
+#include "glyph_cache.h"
+
+#define GLYPH_CACHE_ENTRIES (GLYPH_CACHE_BYTES / GLYPH_BYTES(1))
+#define GLYPH_ROW_BYTES(size) (6 * 2 * (size))
+
+typedef struct {
+  unsigned short fg, bg;
+  unsigned char c, size;
+  unsigned short offset;   // into pool
+  unsigned long used;      // useClock at last lookup, 0 if the entry is free
+} GlyphEntry;
+
+static unsigned char pool[GLYPH_CACHE_BYTES];
+static GlyphEntry entries[GLYPH_CACHE_ENTRIES];
+static unsigned int poolUsed = 0;
+static unsigned long useClock = 0;
+static char cacheOn = 1;
+static GlyphCacheStats cacheStats;
+
+static void expandRow(unsigned char *dst, unsigned char c, int row,
+                      unsigned int fg, unsigned int bg, unsigned char size) {
+  unsigned char bits = fontRows[c*8 + row];
+  unsigned int pix;
+  int i, k;
+
+  for (i = 0; i < 6; i++) {
+    pix = ((bits >> i) & 0x1) ? fg : bg;
+    for (k = 0; k < size; k++) {
+      *dst++ = pix >> 8;
+      *dst++ = pix;
+    }
+  }
+}
+
+// Row of a glyph from the top, bit i set for column i
+unsigned char glyphRowBits(unsigned char c, int row) {
+  return fontRows[c*8 + row];
+}
+
+// Moves the live entries down to the start of the pool, in pool order
+static void compact(void) {
+  unsigned int next = 0;
+  int i, pick;
+
+  for (;;) {
+    pick = -1;
+    for (i = 0; i < GLYPH_CACHE_ENTRIES; i++) {
+      if (entries[i].used && entries[i].offset >= next &&
+          (pick < 0 || entries[i].offset < entries[pick].offset)) {
+        pick = i;
+      }
+    }
+    if (pick < 0) break;
+
+    memmove(&pool[next], &pool[entries[pick].offset],
+            GLYPH_BYTES(entries[pick].size));
+    entries[pick].offset = next;
+    next += GLYPH_BYTES(entries[pick].size);
+  }
+  poolUsed = next;
+}
+
+// Entry holding the glyph, expanded on a miss. -1 if it cannot be placed
+// without evicting a glyph looked up since pinned.
+static int lookup(unsigned char c, unsigned int fg, unsigned int bg,
+                  unsigned char size, unsigned long pinned) {
+  unsigned int need = GLYPH_BYTES(size);
+  int i, slot, lru;
+  int row;
+  char evicted = 0;
+
+  useClock++;
+  for (i = 0; i < GLYPH_CACHE_ENTRIES; i++) {
+    if (entries[i].used && entries[i].c == c && entries[i].size == size &&
+        entries[i].fg == (unsigned short)fg && entries[i].bg == (unsigned short)bg) {
+      entries[i].used = useClock;
+      cacheStats.hits++;
+      return i;
+    }
+  }
+  cacheStats.misses++;
+  if (need > GLYPH_CACHE_BYTES) return -1;
+
+  for (;;) {
+    for (slot = 0; slot < GLYPH_CACHE_ENTRIES && entries[slot].used; slot++);
+    if (slot < GLYPH_CACHE_ENTRIES && poolUsed + need <= GLYPH_CACHE_BYTES) break;
+
+    lru = -1;
+    for (i = 0; i < GLYPH_CACHE_ENTRIES; i++) {
+      if (entries[i].used && entries[i].used < pinned &&
+          (lru < 0 || entries[i].used < entries[lru].used)) {
+        lru = i;
+      }
+    }
+    if (lru < 0) {
+      if (evicted) compact();
+      return -1;
+    }
+
+    entries[lru].used = 0;
+    poolUsed -= GLYPH_BYTES(entries[lru].size);
+    cacheStats.evictions++;
+    evicted = 1;
+  }
+  if (evicted) compact();
+
+  entries[slot].c = c;
+  entries[slot].size = size;
+  entries[slot].fg = fg;
+  entries[slot].bg = bg;
+  entries[slot].offset = poolUsed;
+  entries[slot].used = useClock;
+  for (row = 0; row < 8; row++) {
+    expandRow(&pool[poolUsed + row * GLYPH_ROW_BYTES(size)], c, row, fg, bg, size);
+  }
+  poolUsed += need;
+
+  return slot;
+}
+
+// The window must be n*6*size x 8*size and lie on screen
+void glyphStream(const unsigned char *str, int n, unsigned int color,
+                 unsigned int bg, unsigned char size) {
+  unsigned char line[2 * SSD1351WIDTH];
+  int slot[SSD1351WIDTH / 6];
+  unsigned long pinned = useClock + 1;
+  int row, rep, k;
+
+  for (k = 0; k < n; k++) {
+    slot[k] = cacheOn ? lookup(str[k], color, bg, size, pinned) : -1;
+  }
+
+  for (row = 0; row < 8; row++) {
+    for (k = 0; k < n; k++) {
+      if (slot[k] >= 0) {
+        memcpy(&line[k * GLYPH_ROW_BYTES(size)],
+               &pool[entries[slot[k]].offset + row * GLYPH_ROW_BYTES(size)],
+               GLYPH_ROW_BYTES(size));
+      } else {
+        expandRow(&line[k * GLYPH_ROW_BYTES(size)], str[k], row, color, bg, size);
+      }
+    }
+    for (rep = 0; rep < size; rep++) {
+      pushPixels(line, (unsigned long)n * 6 * size);
+    }
+  }
+}
+
+void setGlyphCache(char on) {
+  cacheOn = on;
+}
+
+void getGlyphCacheStats(GlyphCacheStats *stats) {
+  *stats = cacheStats;
+}
+
+void resetGlyphCacheStats(void) {
+  memset(&cacheStats, 0, sizeof(cacheStats));
+}
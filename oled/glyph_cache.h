@@ -0,0 +1,31 @@
+/*
+ * glyph_cache.h
+ *
+ * Expands font glyphs to RGB565 for the windowed text path and keeps the
+ * most recently used expansions, keyed by character, colours and size.
+ */
+
+#ifndef OLED_GLYPH_CACHE_H_
+#define OLED_GLYPH_CACHE_H_
+
+// Bytes of expanded pixels kept; a glyph of size s takes GLYPH_BYTES(s)
+#ifndef GLYPH_CACHE_BYTES
+#define GLYPH_CACHE_BYTES 2048
+#endif
+
+#define GLYPH_BYTES(size) (8 * 6 * 2 * (size))
+
+typedef struct {
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long evictions;
+} GlyphCacheStats;
+
+void glyphStream(const unsigned char *str, int n, unsigned int color,
+                 unsigned int bg, unsigned char size);
+unsigned char glyphRowBits(unsigned char c, int row);
+void setGlyphCache(char on);
+void getGlyphCacheStats(GlyphCacheStats *stats);
+void resetGlyphCacheStats(void);
+
+#endif /* OLED_GLYPH_CACHE_H_ */
@@ -0,0 +1,121 @@
+/*
+ * test_async.c
+ *
+ * The asynchronous transmit queue, with asyncHostService() standing in for
+ * the SPI interrupt. More segments are queued than the queue holds, so
+ * queueing has to wait for slots to drain; every byte must still come out
+ * once, in order, with the right DC level, each done callback must run
+ * after the last byte of its segment, and the idle callback once the queue
+ * has emptied.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+
+#define SEGMENTS (3 * ASYNC_QUEUE_LEN)
+#define MAX_BYTES (SEGMENTS * 8)
+
+static unsigned char sentByte[MAX_BYTES];
+static unsigned char sentDC[MAX_BYTES];
+static unsigned int numSent = 0;
+
+static unsigned char data[SEGMENTS][7];
+static int doneOrder[SEGMENTS];
+static unsigned int doneAt[SEGMENTS];
+static int numDone = 0;
+static int idleCalls = 0;
+static int failures = 0;
+
+#define CHECK(cond, ...)                         \
+  do {                                           \
+    if (!(cond)) {                               \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+      printf(__VA_ARGS__);                       \
+      printf("\n");                              \
+      failures++;                                \
+    }                                            \
+  } while (0)
+
+static void sink(int dc, unsigned char b) {
+  if (numSent < MAX_BYTES) {
+    sentByte[numSent] = b;
+    sentDC[numSent] = dc;
+  }
+  numSent++;
+}
+
+static void segmentDone(void *arg) {
+  int i = (int)(long)arg;
+
+  doneOrder[numDone++] = i;
+  doneAt[i] = numSent;
+}
+
+static void idle(void) {
+  idleCalls++;
+}
+
+// Command i is followed by a data segment of 1 + i % 7 bytes
+static unsigned int dataLen(int i) {
+  return 1 + i % 7;
+}
+
+int main(void) {
+  unsigned int expected[SEGMENTS], pos = 0, drainedEarly;
+  unsigned int i, k;
+
+  setHostSpiSink(sink);
+  asyncInit();
+  asyncSetIdleCallback(idle);
+
+  for (i = 0; i < SEGMENTS; i++) {
+    for (k = 0; k < dataLen(i); k++) data[i][k] = i * 7 + k;
+    asyncQueueCommand(0x80 | (i & 0x3F));
+    asyncQueueData(data[i], dataLen(i), segmentDone, (void *)(long)i);
+    CHECK(asyncPending() < ASYNC_QUEUE_LEN, "pending %u", asyncPending());
+  }
+  drainedEarly = numSent;
+  CHECK(drainedEarly > 0, "a full queue must drain while queueing");
+  CHECK(asyncBusy(), "queue idle before the fence");
+  CHECK(idleCalls == 0, "idle callback ran with segments queued");
+
+  asyncFence();
+  CHECK(!asyncBusy(), "queue busy after the fence");
+  CHECK(asyncPending() == 0, "pending %u after the fence", asyncPending());
+  CHECK(idleCalls == 1, "idle callback ran %d times", idleCalls);
+
+  // the byte stream: each command, then its data, DC low then high
+  for (i = 0; i < SEGMENTS; i++) {
+    CHECK(pos < numSent && sentByte[pos] == (0x80 | (i & 0x3F)) &&
+          sentDC[pos] == 0, "segment %u: command byte at %u", i, pos);
+    pos++;
+    for (k = 0; k < dataLen(i); k++, pos++) {
+      CHECK(pos < numSent && sentByte[pos] == data[i][k] && sentDC[pos] == 1,
+            "segment %u: data byte %u at %u", i, k, pos);
+    }
+    expected[i] = pos;
+  }
+  CHECK(numSent == pos, "%u bytes sent, %u queued", numSent, pos);
+
+  // done callbacks: in order, each once its last byte is out
+  CHECK(numDone == SEGMENTS, "%d done callbacks for %d segments",
+        numDone, SEGMENTS);
+  for (i = 0; i < (unsigned int)numDone; i++) {
+    CHECK(doneOrder[i] == (int)i, "done callback %u was segment %d",
+          i, doneOrder[i]);
+    CHECK(doneAt[i] == expected[i], "segment %u done after %u bytes, not %u",
+          i, doneAt[i], expected[i]);
+  }
+
+  // an empty data segment completes at once and sends nothing
+  numDone = 0;
+  asyncQueueData(data[0], 0, segmentDone, (void *)0L);
+  CHECK(numDone == 1 && numSent == pos && !asyncBusy(),
+        "empty segment: %d done, %u bytes", numDone, numSent - pos);
+
+  printf("test_async: %u segments, %u bytes, %u drained while queueing: %s\n",
+         2 * SEGMENTS, numSent, drainedEarly, failures ? "FAIL" : "ok");
+  return failures != 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * test_bus.c
+ *
+ * Bus traffic of the direct-drawing primitives, with the window cache off
+ * and on. Each step starts from the controller state the previous one left
+ * behind, so the counts show exactly what the cache saves: a repeated fill
+ * or the right-hand neighbour of the last pixel sends no window at all, and
+ * a window that only moves vertically resends only its rows. The bytes that
+ * reach the sink must agree with the counters.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+
+typedef struct {
+  const char *name;
+  void (*draw)(void);
+  OledBusStats off, on;   // csCycles, dcToggles, cmdBytes, dataBytes
+} BusStep;
+
+static unsigned long sinkCmd = 0, sinkData = 0;
+static int failures = 0;
+
+#define CHECK(cond, ...)                         \
+  do {                                           \
+    if (!(cond)) {                               \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+      printf(__VA_ARGS__);                       \
+      printf("\n");                              \
+      failures++;                                \
+    }                                            \
+  } while (0)
+
+static void sink(int dc, unsigned char b) {
+  if (dc) sinkData++; else sinkCmd++;
+}
+
+static void screen(void) { fillScreen(0xF800); }
+static void pixel(void) { drawPixel(10, 10, 0x07E0); }
+static void nextPixel(void) { drawPixel(11, 10, 0x07E0); }
+static void rect(void) { fillRect(20, 30, 8, 4, 0x001F); }
+
+static void window(void) {
+  startWrite();
+  setAddrWindow(20, 30, 27, 33);
+  endWrite();
+}
+
+static void windowDown(void) {
+  startWrite();
+  setAddrWindow(20, 40, 27, 43);
+  endWrite();
+}
+
+// Adafruit_Init() leaves the full-screen window set and a command last
+static const BusStep steps[] = {
+  { "fillScreen",          screen,     {1, 5, 3, 32772}, {1, 1, 1, 32768} },
+  { "fillScreen again",    screen,     {1, 6, 3, 32772}, {1, 0, 0, 32768} },
+  { "drawPixel",           pixel,      {1, 6, 3, 6},     {1, 6, 3, 6} },
+  { "drawPixel next",      nextPixel,  {1, 6, 3, 6},     {1, 0, 0, 2} },
+  { "fillRect",            rect,       {1, 6, 3, 68},    {1, 6, 3, 68} },
+  { "fillRect again",      rect,       {1, 6, 3, 68},    {1, 0, 0, 64} },
+  { "setAddrWindow same",  window,     {1, 5, 3, 4},     {0, 0, 0, 0} },
+  { "setAddrWindow rows",  windowDown, {1, 4, 3, 4},     {1, 3, 2, 2} },
+};
+
+static void run(char cache) {
+  const BusStep *s;
+  const OledBusStats *want;
+  OledBusStats got;
+
+  setWindowCache(cache);
+  Adafruit_Init();
+
+  for (s = steps; s < steps + sizeof(steps) / sizeof(steps[0]); s++) {
+    want = cache ? &s->on : &s->off;
+    resetBusStats();
+    sinkCmd = sinkData = 0;
+    s->draw();
+    getBusStats(&got);
+
+    CHECK(memcmp(&got, want, sizeof(got)) == 0,
+          "cache %s, %s: cs %lu dc %lu cmd %lu data %lu, "
+          "expected cs %lu dc %lu cmd %lu data %lu",
+          cache ? "on" : "off", s->name, got.csCycles, got.dcToggles,
+          got.cmdBytes, got.dataBytes, want->csCycles, want->dcToggles,
+          want->cmdBytes, want->dataBytes);
+    CHECK(sinkCmd == got.cmdBytes && sinkData == got.dataBytes,
+          "cache %s, %s: sink saw %lu command and %lu data bytes",
+          cache ? "on" : "off", s->name, sinkCmd, sinkData);
+  }
+}
+
+int main(void) {
+  setHostSpiSink(sink);
+
+  run(0);
+  run(1);
+
+  printf("test_bus: %u steps, window cache off and on: %s\n",
+         (unsigned int)(sizeof(steps) / sizeof(steps[0])),
+         failures ? "FAIL" : "ok");
+  return failures != 0;
+}
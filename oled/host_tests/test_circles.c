@@ -0,0 +1,50 @@
+/*
+ * test_circles.c
+ *
+ * circle_spans.h is generated offline from the midpoint loops. Every radius
+ * it holds must give the same outline and fill spans as the loops do with
+ * the tables turned off, so a change to either side cannot go unnoticed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+#include "Adafruit_GFX.h"
+#include "circle_spans.h"
+
+static int failures = 0;
+
+static int sameSpans(const char *what, int r, const unsigned char *table,
+                     const unsigned char *loop) {
+  int dy;
+
+  for (dy = 0; dy <= r; dy++) {
+    if (table[dy] != loop[dy]) {
+      printf("FAIL r=%d %s[%d]: table %u, midpoint loop %u\n",
+             r, what, dy, table[dy], loop[dy]);
+      failures++;
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int main(void) {
+  unsigned char lo[WIDTH], hi[WIDTH], hw[WIDTH];
+  unsigned int i, n = sizeof(circleSpans) / sizeof(circleSpans[0]);
+
+  setCircleTables(0);
+  for (i = 0; i < n; i++) {
+    const CircleSpans *c = &circleSpans[i];
+
+    circleOutlineSpans(c->r, lo, hi);
+    circleFillSpans(c->r, hw);
+    sameSpans("lo", c->r, c->lo, lo);
+    sameSpans("hi", c->r, c->hi, hi);
+    sameSpans("hw", c->r, c->hw, hw);
+  }
+
+  printf("test_circles: %u radii: %s\n", n, failures ? "FAIL" : "ok");
+  return failures != 0;
+}
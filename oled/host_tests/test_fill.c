@@ -0,0 +1,174 @@
+/*
+ * test_fill.c
+ *
+ * Constant-colour fills drawn straight to the panel, with word packing and
+ * FIFO feeding each on and off. Fills shorter than SPI_PACK_MIN_PIXELS, odd
+ * pixel counts, a fill repeated into a cached window, the score bar wipe
+ * and the full screen are checked: every fill must send two data bytes per
+ * pixel, and the bytes sent are fed to a small model of the controller's
+ * RAM, which must hold exactly the rectangles drawn. The fill rate against
+ * the byte sink is printed for comparison between builds; it says nothing
+ * about the rate on the board.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "Adafruit_SSD1351.h"
+
+#define RATE_FILLS 50
+
+typedef struct {
+  int x, y, w, h;
+} Fill;
+
+static const Fill fills[] = {
+  {  5,   5,   1,   1 },
+  { 10,  20,   3,   5 },   // 15 pixels, below the packing threshold
+  { 40,  40,   4,   4 },   // exactly the threshold
+  { 40,  40,   4,   4 },   // again, into the cached window
+  { 60,  70,   5,   5 },   // odd and packed
+  { 90,  10,  17,   3 },
+  {120, 120,  20,  20 },   // clipped at the corner
+  {  0,   0, SSD1351WIDTH, 8 },   // score bar wipe
+};
+
+#define NUM_FILLS (sizeof(fills) / sizeof(fills[0]))
+
+// drawn with fillScreen() after the rest
+static const Fill screen = { 0, 0, SSD1351WIDTH, SSD1351HEIGHT };
+
+static unsigned short panel[SSD1351HEIGHT][SSD1351WIDTH];
+static unsigned short expected[SSD1351HEIGHT][SSD1351WIDTH];
+static int cmd = -1, arg, col0, col1, row0, row1, px, py, half;
+static unsigned char high;
+static unsigned long sinkData = 0, sinkPixelBytes = 0;
+static int failures = 0;
+
+#define CHECK(cond, ...)                         \
+  do {                                           \
+    if (!(cond)) {                               \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+      printf(__VA_ARGS__);                       \
+      printf("\n");                              \
+      failures++;                                \
+    }                                            \
+  } while (0)
+
+static void sink(int dc, unsigned char b) {
+  if (!dc) {
+    cmd = b;
+    arg = 0;
+    half = 0;
+    if (cmd == SSD1351_CMD_WRITERAM) {
+      px = col0;
+      py = row0;
+    }
+    return;
+  }
+  sinkData++;
+  if (cmd == SSD1351_CMD_SETCOLUMN) {
+    if (arg++ == 0) col0 = b; else col1 = b;
+  } else if (cmd == SSD1351_CMD_SETROW) {
+    if (arg++ == 0) row0 = b; else row1 = b;
+  } else if (cmd == SSD1351_CMD_WRITERAM) {
+    if (!half) {
+      high = b;
+      half = 1;
+      return;
+    }
+    half = 0;
+    sinkPixelBytes += 2;
+    panel[py][px] = (high << 8) | b;
+    if (++px > col1) {
+      px = col0;
+      if (++py > row1) py = row0;
+    }
+  }
+}
+
+// The clipped area of f, drawn into the expected panel
+static long expect(const Fill *f, unsigned int color) {
+  int x, y;
+  long area = 0;
+
+  for (y = f->y; y < f->y + f->h && y < SSD1351HEIGHT; y++) {
+    for (x = f->x; x < f->x + f->w && x < SSD1351WIDTH; x++) {
+      expected[y][x] = color;
+      area++;
+    }
+  }
+  return area;
+}
+
+static void run(char packing, char fifo) {
+  OledBusStats bus;
+  unsigned int i, color;
+  long area;
+  int x, y, bad;
+
+  setSpiWordPacking(packing);
+  setSpiFifoFill(fifo);
+
+  for (i = 0; i <= NUM_FILLS; i++) {
+    const Fill *f = i < NUM_FILLS ? &fills[i] : &screen;
+
+    color = 0x1234 + 0x0F0F * i + 0x4000 * packing + 0x2000 * fifo;
+    area = expect(f, color);
+
+    resetBusStats();
+    sinkData = sinkPixelBytes = 0;
+    if (f == &screen) fillScreen(color);
+    else fillRect(f->x, f->y, f->w, f->h, color);
+    getBusStats(&bus);
+
+    // the window's arguments are data too
+    CHECK(sinkPixelBytes == 2 * area && sinkData == bus.dataBytes,
+          "packing %d, fifo %d, fill %u: %lu pixel bytes for %ld pixels, "
+          "%lu data bytes counted, %lu sent", packing, fifo, i,
+          sinkPixelBytes, area, bus.dataBytes, sinkData);
+
+    bad = 0;
+    for (y = 0; y < SSD1351HEIGHT; y++) {
+      for (x = 0; x < SSD1351WIDTH; x++) {
+        if (panel[y][x] != expected[y][x]) bad++;
+      }
+    }
+    CHECK(bad == 0, "packing %d, fifo %d, fill %u: %d pixels wrong",
+          packing, fifo, i, bad);
+  }
+}
+
+// Pixels per millisecond of full-screen fills into the byte sink
+static long fillRate(void) {
+  clock_t start, ticks;
+  int i;
+
+  start = clock();
+  for (i = 0; i < RATE_FILLS; i++) fillScreen(i & 1 ? 0xFFFF : 0x0000);
+  ticks = clock() - start;
+  if (ticks <= 0) ticks = 1;
+  return (long)((double)RATE_FILLS * SSD1351WIDTH * SSD1351HEIGHT *
+                CLOCKS_PER_SEC / 1000 / ticks);
+}
+
+int main(void) {
+  long bytewise, packed;
+
+  setHostSpiSink(sink);
+
+  run(0, 0);
+  run(0, 1);
+  run(1, 0);
+  run(1, 1);
+
+  setSpiWordPacking(0);
+  bytewise = fillRate();
+  setSpiWordPacking(1);
+  packed = fillRate();
+
+  printf("test_fill: %ld px/ms byte by byte, %ld px/ms packed (host): %s\n",
+         bytewise, packed, failures ? "FAIL" : "ok");
+  return failures != 0;
+}
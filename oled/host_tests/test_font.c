@@ -0,0 +1,44 @@
+/*
+ * test_font.c
+ *
+ * glcdfont_rows.h is font[] of glcdfont.h transposed offline to rows. Every
+ * character must have the same pixels in both tables.
+ */
+
+#include <stdio.h>
+
+#include "glcdfont.h"
+#include "glcdfont_rows.h"
+
+#define CHARS (sizeof(font) / 5)
+
+static int failures = 0;
+
+int main(void) {
+  unsigned int c, row, col, bits;
+
+  if (sizeof(fontRows) != 8 * CHARS) {
+    printf("FAIL %u rows for %u characters\n",
+           (unsigned int)sizeof(fontRows), (unsigned int)CHARS);
+    failures++;
+  }
+
+  for (c = 0; c < CHARS && !failures; c++) {
+    for (row = 0; row < 8; row++) {
+      // column i of font[] holds row r in bit r
+      bits = 0;
+      for (col = 0; col < 5; col++) {
+        bits |= ((font[c*5 + col] >> row) & 1) << col;
+      }
+      if (fontRows[c*8 + row] != bits) {
+        printf("FAIL character %u row %u: 0x%02X in fontRows[], 0x%02X in "
+               "font[]\n", c, row, fontRows[c*8 + row], bits);
+        failures++;
+      }
+    }
+  }
+
+  printf("test_font: %u characters: %s\n", (unsigned int)CHARS,
+         failures ? "FAIL" : "ok");
+  return failures != 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * test_layers.c
+ *
+ * The layered compositor against the same scene drawn from scratch each
+ * frame: a static arena, then moving circles. Built once with the default
+ * cache and once with a cache too small for the arena, where the static
+ * shapes are rendered again in every box; both must give the same frames.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+#include "Adafruit_GFX.h"
+#include "layers.h"
+
+#define WALL  0x7BEF
+#define POND  0x001F
+#define SHOT  0xFFFF
+#define OBJECTS 6
+#define FRAMES 40
+
+static unsigned short layered[SSD1351HEIGHT][SSD1351WIDTH];
+static int failures = 0;
+
+static void arena(int scan) {
+  if (scan) {
+    scanFillRect(0, 10, SSD1351WIDTH, 2, WALL);
+    scanFillRect(0, 10, 2, SSD1351HEIGHT - 10, WALL);
+    scanFillRect(60, 50, 8, 28, WALL);
+    scanFillCircle(30, 100, 10, POND);
+    scanCircle(96, 90, 12, POND);
+    scanLine(20, 30, 100, 118, WALL);
+  } else {
+    fillRect(0, 10, SSD1351WIDTH, 2, WALL);
+    fillRect(0, 10, 2, SSD1351HEIGHT - 10, WALL);
+    fillRect(60, 50, 8, 28, WALL);
+    fillCircle(30, 100, 10, POND);
+    drawCircle(96, 90, 12, POND);
+    drawLine(20, 30, 100, 118, WALL);
+  }
+}
+
+static void objects(int scan, int f) {
+  int i, x, y;
+
+  for (i = 0; i < OBJECTS; i++) {
+    x = (i * 37 + f * (2 + i % 3)) % 136 - 4;
+    y = 12 + (i * 23 + f * (3 - i % 3)) % 120;
+    if (scan) {
+      scanCircle(x, y, 3, SHOT);
+    } else {
+      drawCircle(x, y, 3, SHOT);
+    }
+  }
+}
+
+int main(void) {
+  ScanlineStats scan;
+  LayerStats stats;
+  int f, cached, bad = 0;
+
+  fillScreen(0x1234);
+  layerStaticBegin(0);
+  arena(1);
+  cached = layerStaticEnd();
+
+  for (f = 0; f < FRAMES; f++) {
+    layerFrameBegin();
+    objects(1, f);
+    layerFrameEnd();
+    getScanlineStats(&scan);
+    if (scan.shapesDropped) {
+      printf("FAIL frame %d: %lu shapes dropped\n", f, scan.shapesDropped);
+      failures++;
+    }
+    memcpy(layered, frameBuffer, sizeof(layered));
+
+    fillScreen(0);
+    arena(0);
+    objects(0, f);
+    if (memcmp(layered, frameBuffer, sizeof(layered))) bad++;
+    memcpy(frameBuffer, layered, sizeof(layered));
+  }
+  if (bad) {
+    printf("FAIL %d of %d frames differ from a full redraw\n", bad, FRAMES);
+    failures++;
+  }
+
+  getLayerStats(&stats);
+  printf("test_layers (%s): %u runs, %lu px last frame: %s\n",
+         cached ? "cached" : "not cached", stats.staticRuns,
+         stats.pixelsComposited, failures ? "FAIL" : "ok");
+  return failures != 0;
+}
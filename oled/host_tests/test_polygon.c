@@ -0,0 +1,181 @@
+/*
+ * test_polygon.c
+ *
+ * fillPolygon() against golden images of a few shapes (convex, concave and
+ * self-crossing, where the even-odd rule leaves holes), then against a
+ * brute-force even-odd test of every pixel for random polygons, some far
+ * larger than the screen and some drawn inside a clip rectangle. A pixel
+ * is inside when its top left corner is.
+ *
+ * Built with a framebuffer, so the result is read straight from RAM.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+#include "polygon.h"
+
+#define ORIGIN 2
+#define LIT 0xFFFF
+
+typedef struct {
+  const char *name;
+  PolyPoint points[8];
+  int n;
+  const char *image[16];
+} Golden;
+
+static const Golden goldens[] = {
+  {"square", {{1, 1}, {5, 1}, {5, 5}, {1, 5}}, 4, {
+    "......",
+    ".####.",
+    ".####.",
+    ".####.",
+    ".####.",
+    "......",
+  }},
+  {"triangle", {{0, 0}, {10, 0}, {0, 8}}, 3, {
+    "##########.",
+    "#########..",
+    "########...",
+    "#######....",
+    "#####......",
+    "####.......",
+    "###........",
+    "##.........",
+    "...........",
+  }},
+  {"notch", {{0, 0}, {10, 0}, {10, 8}, {6, 8}, {6, 3}, {4, 3}, {4, 8},
+             {0, 8}}, 8, {
+    "##########.",
+    "##########.",
+    "##########.",
+    "####..####.",
+    "####..####.",
+    "####..####.",
+    "####..####.",
+    "####..####.",
+    "...........",
+  }},
+  {"star", {{6, 0}, {10, 11}, {0, 4}, {12, 4}, {2, 11}}, 5, {
+    ".............",
+    "......#......",
+    "......#......",
+    ".....###.....",
+    "#####...####.",
+    "..###...###..",
+    "...#.....#...",
+    "....#...#....",
+    "....##.##....",
+    "...##...##...",
+    "...#.....#...",
+    ".............",
+  }},
+  {"bowtie", {{0, 0}, {10, 6}, {10, 0}, {0, 6}}, 4, {
+    "...........",
+    "##.......#.",
+    "####...###.",
+    "##########.",
+    "####...###.",
+    "##.......#.",
+    "...........",
+  }},
+};
+
+static int failures = 0;
+
+static int lit(int x, int y) {
+  return frameBuffer[y][x] != 0;
+}
+
+// Golden image at ORIGIN, nothing anywhere else
+static void checkGolden(const Golden *g) {
+  int x, y, w = strlen(g->image[0]), h, expect, bad = 0;
+
+  for (h = 0; g->image[h]; h++) {}
+
+  fillScreen(0);
+  fillPolygon(ORIGIN, ORIGIN, g->points, g->n, LIT);
+  for (y = 0; y < SSD1351HEIGHT; y++) {
+    for (x = 0; x < SSD1351WIDTH; x++) {
+      expect = x >= ORIGIN && x < ORIGIN + w && y >= ORIGIN && y < ORIGIN + h &&
+               g->image[y - ORIGIN][x - ORIGIN] == '#';
+      if (lit(x, y) != expect) bad++;
+    }
+  }
+  if (bad) {
+    printf("FAIL golden %s: %d pixels differ\n", g->name, bad);
+    failures++;
+  }
+}
+
+// Even-odd: crossings of the ray from (x, y) to the right
+static int inside(const PolyPoint *p, int n, int ox, int oy, int x, int y) {
+  int i, c = 0, x0, y0, x1, y1, t;
+
+  for (i = 0; i < n; i++) {
+    x0 = ox + p[i].x;
+    y0 = oy + p[i].y;
+    x1 = ox + p[(i + 1) % n].x;
+    y1 = oy + p[(i + 1) % n].y;
+    if (y0 == y1) continue;
+    if (y0 > y1) {
+      t = x0; x0 = x1; x1 = t;
+      t = y0; y0 = y1; y1 = t;
+    }
+    if (y < y0 || y >= y1) continue;
+    if ((long)(y - y0) * (x1 - x0) <= (long)(x - x0) * (y1 - y0)) c ^= 1;
+  }
+  return c;
+}
+
+static void checkRandom(int count) {
+  PolyPoint p[POLY_MAX_POINTS];
+  int t, i, n, x, y, ox, oy, clip, span, expect, bad = 0;
+
+  srand(3);
+  for (t = 0; t < count; t++) {
+    ox = rand() % 40;
+    oy = rand() % 40;
+    clip = t % 3 == 0;
+    n = 3 + rand() % (t % 5 == 0 ? POLY_MAX_POINTS - 2 : 8);
+    span = t % 7 == 0 ? 400 : 140;
+    for (i = 0; i < n; i++) {
+      p[i].x = rand() % span - (span - 80) / 2;
+      p[i].y = rand() % span - (span - 80) / 2;
+    }
+
+    fillScreen(0);
+    if (clip) pushClipRect(13, 7, 90, 100);
+    fillPolygon(ox, oy, p, n, LIT);
+    if (clip) popClipRect();
+
+    for (y = 0; y < SSD1351HEIGHT; y++) {
+      for (x = 0; x < SSD1351WIDTH; x++) {
+        expect = inside(p, n, ox, oy, x, y) &&
+                 (!clip || (x >= 13 && x < 103 && y >= 7 && y < 107));
+        if (lit(x, y) != expect) bad++;
+      }
+    }
+    if (bad) {
+      printf("FAIL random polygon %d (%d corners): %d pixels differ\n",
+             t, n, bad);
+      failures++;
+      return;
+    }
+  }
+}
+
+int main(void) {
+  unsigned int i;
+
+  for (i = 0; i < sizeof(goldens) / sizeof(goldens[0]); i++) {
+    checkGolden(&goldens[i]);
+  }
+  checkRandom(400);
+
+  printf("test_polygon: %s\n", failures ? "FAIL" : "ok");
+  return failures != 0;
+}
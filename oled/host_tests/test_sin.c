@@ -0,0 +1,30 @@
+/*
+ * test_sin.c
+ *
+ * sin_table.h is generated offline. Every entry must be sin(d) in Q16,
+ * rounded to nearest, as the C library computes it.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "sin_table.h"
+
+static int failures = 0;
+
+int main(void) {
+  int d;
+  long want;
+
+  for (d = 0; d <= 90; d++) {
+    want = lround(sin(d * M_PI / 180) * 65536);
+    if (sinQ16Table[d] != want) {
+      printf("FAIL sin(%d): %d in the table, %ld computed\n",
+             d, sinQ16Table[d], want);
+      failures++;
+    }
+  }
+
+  printf("test_sin: 91 degrees: %s\n", failures ? "FAIL" : "ok");
+  return failures != 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * test_sprites.c
+ *
+ * tank_sprites.h is rendered offline with drawCircle() and drawLine(). Each
+ * of the 8 frames is drawn again here the way it was generated, a radius 6
+ * outline and a 12 pixel cannon, and cropped to the drawn pixels; size, hot
+ * spot, colours and mask must all match the header.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+#include "Adafruit_GFX.h"
+#include "tank_sprites.h"
+
+#define GREEN 0x07E0
+#define CX 64
+#define CY 64
+
+// cannon end per frame, index = direction / 45
+static const int cannonX[8] = {12, 12, 0, -12, -12, -12, 0, 12};
+static const int cannonY[8] = {0, -12, -12, -12, 0, 12, 12, 12};
+
+static int failures = 0;
+
+static void checkFrame(int d) {
+  const SpriteFrame *f = &tankFrames[d];
+  int x, y, x0 = SSD1351WIDTH, y0 = SSD1351HEIGHT, x1 = -1, y1 = -1;
+  int bad = 0, opaque;
+  unsigned int color;
+
+  fillScreen(0);
+  drawCircle(CX, CY, 6, GREEN);
+  drawLine(CX, CY, CX + cannonX[d], CY + cannonY[d], GREEN);
+
+  for (y = 0; y < SSD1351HEIGHT; y++) {
+    for (x = 0; x < SSD1351WIDTH; x++) {
+      if (!frameBuffer[y][x]) continue;
+      if (x < x0) x0 = x;
+      if (x > x1) x1 = x;
+      if (y < y0) y0 = y;
+      if (y > y1) y1 = y;
+    }
+  }
+
+  if (f->w != x1 - x0 + 1 || f->h != y1 - y0 + 1 ||
+      f->ox != x0 - CX || f->oy != y0 - CY) {
+    printf("FAIL frame %d: %dx%d at %d,%d in the header, %dx%d at %d,%d "
+           "drawn\n", d, f->w, f->h, f->ox, f->oy,
+           x1 - x0 + 1, y1 - y0 + 1, x0 - CX, y0 - CY);
+    failures++;
+    return;
+  }
+
+  for (y = 0; y < f->h; y++) {
+    for (x = 0; x < f->w; x++) {
+      color = FB_SWAP(frameBuffer[y0 + y][x0 + x]);
+      opaque = (f->mask[y * ((f->w + 7) / 8) + x / 8] >> (x & 7)) & 1;
+      if (opaque != (color != 0) ||
+          ((f->pixels[2 * (y * f->w + x)] << 8) |
+           f->pixels[2 * (y * f->w + x) + 1]) != color) bad++;
+    }
+  }
+  if (bad) {
+    printf("FAIL frame %d: %d pixels differ from the header\n", d, bad);
+    failures++;
+  }
+}
+
+int main(void) {
+  int d;
+
+  for (d = 0; d < 8; d++) checkFrame(d);
+
+  printf("test_sprites: 8 frames: %s\n", failures ? "FAIL" : "ok");
+  return failures != 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * test_tiles.c
+ *
+ * Framebuffer flushes with SSD1351_TILE_HASH: a tile must be sent whenever
+ * its pixels changed, including changes a position-blind checksum would
+ * miss, such as the same word drawn twice in a tile or equal pixel pairs
+ * a few rows apart. The bytes sent are fed to a small model of the
+ * controller's RAM, which must match the framebuffer after every flush.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+
+static unsigned short panel[SSD1351HEIGHT][SSD1351WIDTH];
+static int cmd = -1, arg, col0, col1, row0, row1, px, py, half;
+static unsigned char high;
+static unsigned long dataBytes = 0;
+static int failures = 0;
+
+static void sink(int dc, unsigned char b) {
+  if (dc) dataBytes++;
+  if (!dc) {
+    cmd = b;
+    arg = 0;
+    half = 0;
+    if (cmd == SSD1351_CMD_WRITERAM) {
+      px = col0;
+      py = row0;
+    }
+    return;
+  }
+  if (cmd == SSD1351_CMD_SETCOLUMN) {
+    if (arg++ == 0) col0 = b; else col1 = b;
+  } else if (cmd == SSD1351_CMD_SETROW) {
+    if (arg++ == 0) row0 = b; else row1 = b;
+  } else if (cmd == SSD1351_CMD_WRITERAM) {
+    if (!half) {
+      high = b;
+      half = 1;
+      return;
+    }
+    half = 0;
+    panel[py][px] = (high << 8) | b;
+    if (++px > col1) {
+      px = col0;
+      if (++py > row1) py = row0;
+    }
+  }
+}
+
+static void check(const char *what) {
+  int x, y, bad = 0;
+
+  flush();
+  asyncFence();
+  for (y = 0; y < SSD1351HEIGHT; y++) {
+    for (x = 0; x < SSD1351WIDTH; x++) {
+      if (panel[y][x] != FB_SWAP(frameBuffer[y][x])) bad++;
+    }
+  }
+  if (bad) {
+    printf("FAIL %s: %d pixels stale on the panel\n", what, bad);
+    failures++;
+  }
+}
+
+int main(void) {
+  FlushStats stats;
+  unsigned long sent;
+
+  setHostSpiSink(sink);
+  asyncInit();
+  col1 = SSD1351WIDTH - 1;
+  row1 = SSD1351HEIGHT - 1;
+
+  fillScreen(0x0000);
+  check("blank screen");
+
+  // two all-ones words in one tile
+  fillRect(0, 0, 2, 1, 0xFFFF);
+  fillRect(4, 0, 2, 1, 0xFFFF);
+  check("white pairs in a row");
+
+  // equal pairs 4 rows apart in the same column
+  fillRect(8, 8, 2, 1, 0x07E0);
+  fillRect(8, 12, 2, 1, 0x07E0);
+  check("green pairs 4 rows apart");
+
+  fillRect(16, 16, 2, 1, 0xFFFF);
+  fillRect(16, 20, 2, 1, 0xFFFF);
+  check("white pairs 4 rows apart");
+
+  // erase and redraw the same thing: nothing changes, nothing is stale
+  fillRect(16, 16, 2, 1, 0x0000);
+  fillRect(16, 16, 2, 1, 0xFFFF);
+  sent = dataBytes;
+  check("redraw unchanged");
+  getFlushStats(&stats);
+  if (stats.tilesSent != 0 || dataBytes != sent) {
+    printf("FAIL redraw unchanged: %u tiles, %lu data bytes sent\n",
+           stats.tilesSent, dataBytes - sent);
+    failures++;
+  }
+
+  fillScreen(0x0000);
+  check("cleared again");
+
+  printf("test_tiles: %s\n", failures ? "FAIL" : "ok");
+  return failures != 0;
+}
@@ -0,0 +1,226 @@
+/*
+ * layers.c
+ *
+ * The static layer (arena, walls, decorations, HUD labels) is described
+ * with the scan* calls between layerStaticBegin() and layerStaticEnd(). It
+ * is rendered once by the scanline renderer into a cache of runs of one
+ * colour, row by row, and then sent to the whole screen from the cache.
+ *
+ * Each frame, the dynamic objects (tank, projectiles, targets) are added
+ * with scan* calls between layerFrameBegin() and layerFrameEnd(). The boxes
+ * they cover, together with the boxes they covered in the last frame, are
+ * the only parts composited: each box is rendered by the scanline renderer
+ * with its rows starting from the cached static layer, so moving objects
+ * leave the static layer behind them intact and the rest of the screen is
+ * not touched. Two boxes are composited as one when their bounding box is
+ * no bigger than the two of them apart.
+ *
+ * Without room for the static layer in the cache, layerStaticEnd() returns
+ * 0 and the static shapes stay in the scanline renderer's list (see
+ * scanMark()); each frame's objects are added after them and every box is
+ * rendered from the shapes again. The screen stays right, at the cost of
+ * rendering the static shapes in each box and of fewer list entries left
+ * for the objects; the static layer's strings and bitmaps must then stay
+ * valid, and the renderer must not be used for other frames, for as long
+ * as the layer is in use.
+ */
+
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+#include "layers.h"
+
+typedef struct {
+  unsigned short color;
+  unsigned char length;
+} LayerRun;
+
+typedef struct {
+  short x0, y0, x1, y1;   // inclusive
+} LayerBox;
+
+static LayerRun runs[LAYER_CACHE_RUNS];
+static unsigned short rowStart[SSD1351HEIGHT + 1];  // first run of each row
+static unsigned int numRuns = 0;
+static int nextRow = 0;
+static unsigned int staticBg = 0;
+static unsigned int staticShapes = 0;   // in the list when not cached
+
+// object boxes of the last frame, and everything to composite in this one
+static LayerBox lastBoxes[SCAN_MAX_SHAPES];
+static unsigned int numLastBoxes = 0;
+static LayerBox boxes[2 * SCAN_MAX_SHAPES];
+
+static LayerStats layerStats;
+
+//*****************************************************************************
+//
+// Static layer cache
+//
+//*****************************************************************************
+static void addRun(unsigned int color, int length) {
+  if (numRuns > rowStart[nextRow] && runs[numRuns-1].color == color &&
+      runs[numRuns-1].length + length <= 255) {
+    runs[numRuns-1].length += length;
+    return;
+  }
+  if (numRuns >= LAYER_CACHE_RUNS) {
+    layerStats.staticCached = 0;
+    return;
+  }
+  runs[numRuns].color = color;
+  runs[numRuns].length = length;
+  numRuns++;
+}
+
+// Rows the renderer did not reach are all background
+static void cacheBlankRows(int y) {
+  for (; nextRow < y; nextRow++) {
+    rowStart[nextRow] = numRuns;
+    addRun(staticBg, SSD1351WIDTH);
+  }
+}
+
+// Sink for the static layer: appends row y as runs
+static void cacheRow(unsigned char *line, int y, int x0, int x1) {
+  unsigned int color;
+  int x;
+
+  cacheBlankRows(y);
+  rowStart[nextRow] = numRuns;
+  if (x0 > 0) addRun(staticBg, x0);
+  for (x = x0; x <= x1; x++) {
+    color = (line[2*x] << 8) | line[2*x + 1];
+    addRun(color, 1);
+  }
+  if (x1 < SSD1351WIDTH - 1) addRun(staticBg, SSD1351WIDTH - 1 - x1);
+  nextRow++;
+}
+
+// Backdrop for compositing: columns x0..x1 of row y of the cached layer
+static void staticRow(unsigned char *line, int y, int x0, int x1) {
+  const LayerRun *r = runs + rowStart[y], *end = runs + rowStart[y + 1];
+  int x = 0, from, to;
+  unsigned char *p;
+
+  for (; r < end && x <= x1; x += (r++)->length) {
+    from = x > x0 ? x : x0;
+    to = x + r->length - 1 < x1 ? x + r->length - 1 : x1;
+    for (p = line + 2 * from; from <= to; from++) {
+      *p++ = r->color >> 8;
+      *p++ = r->color;
+    }
+  }
+}
+
+void layerStaticBegin(unsigned int bg) {
+  staticBg = bg;
+  scanBegin(bg);
+}
+
+// Caches the static layer and sends all of it; 0 if it did not fit the
+// cache, when its shapes are kept and rendered again with every frame
+int layerStaticEnd(void) {
+  numRuns = 0;
+  nextRow = 0;
+  numLastBoxes = 0;
+  layerStats.staticCached = 1;
+  scanRender(0, cacheRow);
+  cacheBlankRows(SSD1351HEIGHT);
+  rowStart[SSD1351HEIGHT] = numRuns;
+
+  if (!layerStats.staticCached) {
+    layerStats.staticRuns = 0;
+    staticShapes = scanShapeCount();
+    scanMark();
+    scanRender(0, 0);
+    return 0;
+  }
+
+  // the cache, not the shapes, is the static layer from here on
+  layerStats.staticRuns = numRuns;
+  staticShapes = 0;
+  scanBegin(staticBg);
+  scanRender(staticRow, 0);
+  return 1;
+}
+
+//*****************************************************************************
+//
+// Frames
+//
+//*****************************************************************************
+static long boxArea(const LayerBox *b) {
+  return (long)(b->x1 - b->x0 + 1) * (b->y1 - b->y0 + 1);
+}
+
+// Merges boxes whose bounding box costs no more than they do apart, until
+// no pair qualifies; returns the number left
+static unsigned int mergeBoxes(LayerBox *b, unsigned int n) {
+  LayerBox u;
+  unsigned int i, j;
+  int merged = 1;
+
+  while (merged) {
+    merged = 0;
+    for (i = 0; i < n; i++) {
+      for (j = i + 1; j < n; j++) {
+        u.x0 = b[i].x0 < b[j].x0 ? b[i].x0 : b[j].x0;
+        u.y0 = b[i].y0 < b[j].y0 ? b[i].y0 : b[j].y0;
+        u.x1 = b[i].x1 > b[j].x1 ? b[i].x1 : b[j].x1;
+        u.y1 = b[i].y1 > b[j].y1 ? b[i].y1 : b[j].y1;
+        if (boxArea(&u) <= boxArea(&b[i]) + boxArea(&b[j])) {
+          b[i] = u;
+          b[j] = b[--n];
+          merged = 1;
+          j = i;
+        }
+      }
+    }
+  }
+  return n;
+}
+
+void layerFrameBegin(void) {
+  if (layerStats.staticCached) {
+    scanBegin(staticBg);
+  } else {
+    scanRewind();
+  }
+}
+
+void layerFrameEnd(void) {
+  unsigned int i, n, objects = scanShapeCount() - staticShapes;
+  int x0, y0, x1, y1;
+
+  // where the objects were, then where they are
+  memcpy(boxes, lastBoxes, numLastBoxes * sizeof(LayerBox));
+  n = numLastBoxes;
+  numLastBoxes = 0;
+  for (i = 0; i < objects; i++) {
+    scanShapeBox(staticShapes + i, &x0, &y0, &x1, &y1);
+    if (!clipRect(&x0, &y0, &x1, &y1)) continue;
+    lastBoxes[numLastBoxes].x0 = x0;
+    lastBoxes[numLastBoxes].y0 = y0;
+    lastBoxes[numLastBoxes].x1 = x1;
+    lastBoxes[numLastBoxes].y1 = y1;
+    boxes[n++] = lastBoxes[numLastBoxes++];
+  }
+  n = mergeBoxes(boxes, n);
+
+  layerStats.frames++;
+  layerStats.objects = objects;
+  layerStats.rects = n;
+  layerStats.pixelsComposited = 0;
+  for (i = 0; i < n; i++) {
+    pushClipRect(boxes[i].x0, boxes[i].y0,
+                 boxes[i].x1 - boxes[i].x0 + 1, boxes[i].y1 - boxes[i].y0 + 1);
+    scanRender(layerStats.staticCached ? staticRow : 0, 0);
+    popClipRect();
+    layerStats.pixelsComposited += boxArea(&boxes[i]);
+  }
+}
+
+void getLayerStats(LayerStats *stats) {
+  *stats = layerStats;
+}
@@ -0,0 +1,34 @@
+/*
+ * layers.h
+ *
+ * Two-layer compositor: a static layer rendered once into a run-length
+ * cache, and dynamic objects added every frame. Only the boxes the objects
+ * cover now or covered in the last frame are composited and sent.
+ */
+
+#ifndef OLED_LAYERS_H_
+#define OLED_LAYERS_H_
+
+#include "scanline.h"
+
+// Runs of one colour the static layer cache holds, 4 bytes each
+#ifndef LAYER_CACHE_RUNS
+#define LAYER_CACHE_RUNS 1024
+#endif
+
+typedef struct {
+  unsigned long frames;
+  unsigned int objects;            // last frame
+  unsigned int rects;              // boxes composited last frame
+  unsigned long pixelsComposited;  // last frame
+  unsigned int staticRuns;         // runs in the cache
+  char staticCached;               // 0: did not fit, shapes drawn each box
+} LayerStats;
+
+void layerStaticBegin(unsigned int bg);
+int layerStaticEnd(void);
+void layerFrameBegin(void);
+void layerFrameEnd(void);
+void getLayerStats(LayerStats *stats);
+
+#endif /* OLED_LAYERS_H_ */
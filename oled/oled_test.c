@@ -9,10 +9,26 @@
 // TODO Configure SPI port and use these libraries to implement
 // an OLED test program. See SPI example program.
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "oled_test.h"
 
+#include "hw_types.h"
+#include "rom.h"
+#include "rom_map.h"
+#include "prcm.h"
+#include "uart_if.h"
+
 #include "Adafruit_GFX.h"
 #include "Adafruit_SSD1351.h"
+#include "glyph_cache.h"
+#include "text_field.h"
+#include "sprite.h"
+#include "scanline.h"
+#include "polygon.h"
+#include "save_under.h"
+#include "layers.h"
 
 static float p = 3.1415926;
 
@@ -194,6 +210,7 @@ void testlines(unsigned int color) {
 void lcdTestPattern(void)
 {
   unsigned int i,j;
+  startWrite();
   goTo(0, 0);
 
   for(i=0;i<128;i++)
@@ -210,11 +227,13 @@ void lcdTestPattern(void)
       else {writeData(WHITE>>8); writeData((unsigned char) WHITE);}
     }
   }
+  endWrite();
 }
 /**************************************************************************/
 void lcdTestPattern2(void)
 {
   unsigned int i,j;
+  startWrite();
   goTo(0, 0);
 
   for(i=0;i<128;i++)
@@ -231,7 +250,827 @@ void lcdTestPattern2(void)
       else {writeData(WHITE>>8);writeData((unsigned char) WHITE);}
     }
   }
+  endWrite();
 }
 
 /**************************************************************************/
 
+//*****************************************************************************
+//  Benchmarks: bus traffic is counted by the driver and printed over UART
+
+// elapsed time from the 32.768 kHz slow clock counter
+static unsigned long long benchStart;
+
+static void benchBegin(void) {
+  benchStart = MAP_PRCMSlowClkCtrGet();
+}
+
+static unsigned long benchElapsedUs(void) {
+  unsigned long long ticks = MAP_PRCMSlowClkCtrGet() - benchStart;
+
+  return (unsigned long)((ticks * 1000000ULL) / 32768ULL);
+}
+
+static void reportRate(const char *name, unsigned long pixels, unsigned long us) {
+  Report("%s: %lu px in %lu us = %lu px/ms\n\r", name, pixels, us,
+         us ? (unsigned long)((unsigned long long)pixels * 1000ULL / us) : 0);
+}
+
+static void reportBus(const char *name, OledBusStats *before, OledBusStats *after) {
+  Report("%s: cmd %lu data %lu  ->  cmd %lu data %lu\n\r", name,
+         before->cmdBytes, before->dataBytes, after->cmdBytes, after->dataBytes);
+}
+
+void benchWindowCache(void) {
+  OledBusStats off, on;
+
+  setWindowCache(0);
+  resetBusStats();
+  testfastlines(RED, BLUE);
+  testdrawrects(GREEN);
+  getBusStats(&off);
+
+  setWindowCache(1);
+  resetBusStats();
+  testfastlines(RED, BLUE);
+  testdrawrects(GREEN);
+  getBusStats(&on);
+
+  reportBus("window cache off/on", &off, &on);
+}
+
+void benchPixelThroughput(void) {
+  unsigned long us;
+
+  Report("SPI at %lu Hz\n\r", getSpiBitRate());
+
+  setSpiWordPacking(0);
+  benchBegin();
+  fillScreen(BLUE);
+  flush();
+  us = benchElapsedUs();
+  reportRate("8-bit words", (unsigned long)width() * height(), us);
+
+  setSpiWordPacking(1);
+  benchBegin();
+  fillScreen(RED);
+  flush();
+  us = benchElapsedUs();
+  reportRate("32-bit words", (unsigned long)width() * height(), us);
+}
+
+// Constant fills as the game does them: full clears and the score bar wipe
+static void fillRateRun(const char *name) {
+  unsigned long us;
+  int i;
+
+  benchBegin();
+  for (i = 0; i < 4; i++) {
+    fillScreen(i & 1 ? BLACK : BLUE);
+    flush();
+  }
+  us = benchElapsedUs();
+  reportRate(name, 4UL * width() * height(), us);
+
+  benchBegin();
+  for (i = 0; i < 32; i++) {
+    fillRect(0, 0, width(), 8, i & 1 ? BLACK : GREEN);
+    flush();
+  }
+  us = benchElapsedUs();
+  reportRate(name, 32UL * width() * 8, us);
+}
+
+void benchFillRate(void) {
+  setSpiFifoFill(0);
+  fillRateRun("fill, round trip per word");
+  setSpiFifoFill(1);
+  fillRateRun("fill, FIFO fed");
+}
+
+// The per-point midpoint circle drawCircle used to be, for comparison
+static void drawCirclePoints(int x0, int y0, int r, unsigned int color) {
+  int f = 1 - r;
+  int ddF_x = 1;
+  int ddF_y = -2 * r;
+  int x = 0;
+  int y = r;
+
+  drawPixel(x0  , y0+r, color);
+  drawPixel(x0  , y0-r, color);
+  drawPixel(x0+r, y0  , color);
+  drawPixel(x0-r, y0  , color);
+
+  while (x<y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+
+    drawPixel(x0 + x, y0 + y, color);
+    drawPixel(x0 - x, y0 + y, color);
+    drawPixel(x0 + x, y0 - y, color);
+    drawPixel(x0 - x, y0 - y, color);
+    drawPixel(x0 + y, y0 + x, color);
+    drawPixel(x0 - y, y0 + x, color);
+    drawPixel(x0 + y, y0 - x, color);
+    drawPixel(x0 - y, y0 - x, color);
+  }
+}
+
+static unsigned long busBytes(void) {
+  OledBusStats stats;
+
+  getBusStats(&stats);
+  return stats.cmdBytes + stats.dataBytes;
+}
+
+void benchCircles(void) {
+  static const int radii[] = {3, 4, 6};
+  unsigned long points, spans, fillCols, fillRows;
+  unsigned int i;
+
+  fillScreen(BLACK);
+  for (i = 0; i < sizeof(radii)/sizeof(radii[0]); i++) {
+    resetBusStats();
+    drawCirclePoints(64, 64, radii[i], GREEN);
+    flush();
+    points = busBytes();
+
+    resetBusStats();
+    drawCircle(64, 64, radii[i], GREEN);
+    flush();
+    spans = busBytes();
+
+    resetBusStats();
+    drawFastVLine(64, 64-radii[i], 2*radii[i]+1, RED);
+    fillCircleHelper(64, 64, radii[i], 3, 0, RED);
+    flush();
+    fillCols = busBytes();
+
+    resetBusStats();
+    fillCircle(64, 64, radii[i], RED);
+    flush();
+    fillRows = busBytes();
+
+    Report("r=%d drawCircle %lu -> %lu bytes, fillCircle %lu -> %lu bytes\n\r",
+           radii[i], points, spans, fillCols, fillRows);
+  }
+}
+
+// Table blits against the midpoint loop for the radii the game draws
+static unsigned long circleTableRun(int r) {
+  int i;
+
+  benchBegin();
+  for (i = 0; i < 64; i++) {
+    drawCircle(8 + (i & 7) * 16, 8 + (i >> 3) * 16, r, GREEN);
+    fillCircle(8 + (i & 7) * 16, 8 + (i >> 3) * 16, r, RED);
+  }
+  flush();
+  return benchElapsedUs();
+}
+
+void benchCircleTables(void) {
+  static const int radii[] = {3, 4, 6};
+  unsigned long computed, table;
+  unsigned int i;
+
+  fillScreen(BLACK);
+  flush();
+  for (i = 0; i < sizeof(radii)/sizeof(radii[0]); i++) {
+    setCircleTables(0);
+    computed = circleTableRun(radii[i]);
+    setCircleTables(1);
+    table = circleTableRun(radii[i]);
+
+    Report("r=%d 64 outline+fill: computed %lu us, table %lu us\n\r",
+           radii[i], computed, table);
+  }
+}
+
+// The per-pixel Bresenham drawLine used to be, for comparison
+static void drawLinePixels(int x0, int y0, int x1, int y1, unsigned int color) {
+  int steep = abs(y1 - y0) > abs(x1 - x0);
+  int dx, dy, err, ystep;
+
+  if (steep) {
+    swap(x0, y0);
+    swap(x1, y1);
+  }
+  if (x0 > x1) {
+    swap(x0, x1);
+    swap(y0, y1);
+  }
+  dx = x1 - x0;
+  dy = abs(y1 - y0);
+  err = dx / 2;
+  ystep = y0 < y1 ? 1 : -1;
+
+  for (; x0<=x1; x0++) {
+    if (steep) drawPixel(y0, x0, color);
+    else       drawPixel(x0, y0, color);
+    err -= dy;
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void benchLineSlopes(void) {
+  // run:rise of each slope, from horizontal to vertical
+  static const int slope[][2] = {{1, 0}, {4, 1}, {2, 1}, {1, 1}, {1, 2}, {0, 1}};
+  static const int lengths[] = {12, 32, 64};
+  unsigned long pixels, runs;
+  unsigned int i, j;
+  int dx, dy;
+
+  for (i = 0; i < sizeof(slope)/sizeof(slope[0]); i++) {
+    for (j = 0; j < sizeof(lengths)/sizeof(lengths[0]); j++) {
+      // major axis spans the whole length
+      if (slope[i][0] >= slope[i][1]) {
+        dx = lengths[j] - 1;
+        dy = dx * slope[i][1] / slope[i][0];
+      } else {
+        dy = lengths[j] - 1;
+        dx = dy * slope[i][0] / slope[i][1];
+      }
+
+      // both start from the full-screen window a clear leaves behind
+      fillScreen(BLACK);
+      flush();
+      resetBusStats();
+      drawLinePixels(16, 16, 16 + dx, 16 + dy, YELLOW);
+      flush();
+      pixels = busBytes();
+
+      fillScreen(BLACK);
+      flush();
+      resetBusStats();
+      drawLine(16, 16, 16 + dx, 16 + dy, CYAN);
+      flush();
+      runs = busBytes();
+
+      Report("slope %d:%d len %d: %lu -> %lu bytes\n\r",
+             slope[i][0], slope[i][1], lengths[j], pixels, runs);
+    }
+  }
+}
+
+// The score HUD redrawn with and without the expanded-glyph cache
+static unsigned long glyphCacheRun(void) {
+  char text[16];
+  int i;
+
+  benchBegin();
+  for (i = 0; i < 100; i++) {
+    sprintf(text, "Score: %d", i);
+    setCursor(0, 0);
+    Outstr(text);
+    flush();
+  }
+  return benchElapsedUs();
+}
+
+void benchGlyphCache(void) {
+  GlyphCacheStats stats;
+  unsigned long off, on;
+
+  setTextColor(WHITE, BLACK);
+  setTextSize(1);
+
+  setGlyphCache(0);
+  off = glyphCacheRun();
+
+  setGlyphCache(1);
+  resetGlyphCacheStats();
+  on = glyphCacheRun();
+  getGlyphCacheStats(&stats);
+
+  Report("100 score updates: %lu us uncached, %lu us cached (%lu hits %lu misses)\n\r",
+         off, on, stats.hits, stats.misses);
+}
+
+// Score increments: wipe and reprint against the text field
+void benchScoreField(void) {
+  TextField field;
+  char text[16];
+  unsigned long wipe, incremental;
+  int i;
+
+  setTextColor(WHITE, BLACK);
+  setTextSize(1);
+  fillScreen(BLACK);
+  flush();
+
+  resetBusStats();
+  for (i = 0; i < 100; i++) {
+    fillRect(0, 0, width(), 8, BLACK);
+    setCursor(0, 0);
+    sprintf(text, "Score: %d", i);
+    Outstr(text);
+  }
+  flush();
+  wipe = busBytes();
+
+  textFieldInit(&field, 0, 0, width(), WHITE, BLACK, 1);
+  textFieldInvalidate(&field);
+  textFieldSet(&field, "Score: 0");
+  field.glyphsDrawn = 0;
+  resetBusStats();
+  for (i = 1; i <= 100; i++) {
+    sprintf(text, "Score: %d", i);
+    textFieldSet(&field, text);
+  }
+  flush();
+  incremental = busBytes();
+
+  Report("100 score updates: %lu -> %lu bytes, %lu glyphs drawn\n\r",
+         wipe, incremental, field.glyphsDrawn);
+}
+
+// The per-pixel drawXBitmap the title page used to be drawn with
+static void drawXBitmapPixels(int x, int y, const unsigned char *bitmap,
+                              int w, int h, unsigned int color) {
+  int i, j, byteWidth = (w + 7) / 8;
+
+  for (j = 0; j < h; j++) {
+    for (i = 0; i < w; i++) {
+      if (bitmap[j * byteWidth + i / 8] & (1 << (i % 8))) {
+        drawPixel(x + i, y + j, color);
+      }
+    }
+  }
+}
+
+static void titlePageRun(const char *name, int mode,
+                         const unsigned char *art, int w, int h) {
+  unsigned long us;
+
+  fillScreen(BLACK);
+  flush();
+  resetBusStats();
+  benchBegin();
+
+  if (mode == 0) drawXBitmapPixels(0, -5, art, w, h, WHITE);
+  else if (mode == 1) drawXBitmap(0, -5, art, w, h, WHITE);
+  else drawXBitmapOpaque(0, -5, art, w, h, WHITE, BLACK);
+
+  setTextColor(RED, BLACK);
+  setCursor(30, 0);
+  Outstr("TANK GAME");
+  setTextColor(WHITE, BLACK);
+  setCursor(0, 121);
+  Outstr("Press any button");
+  flush();
+
+  us = benchElapsedUs();
+  Report("title page, %s: %lu us, %lu bytes\n\r", name, us, busBytes());
+}
+
+// The title page as main.c draws it, art is its XBM
+void benchTitlePage(const unsigned char *art, int w, int h) {
+  titlePageRun("per pixel", 0, art, w, h);
+  titlePageRun("spans", 1, art, w, h);
+  titlePageRun("one window", 2, art, w, h);
+}
+
+// A 32x32 gradient tiled over the screen: column-major drawPixel, as
+// custom_drawBitMap used to, against the streamed blit
+void benchRGBBitmap(void) {
+  static unsigned int tile[32 * 32];
+  unsigned long us, bytes;
+  int i, j, t;
+
+  for (j = 0; j < 32; j++) {
+    for (i = 0; i < 32; i++) {
+      tile[j * 32 + i] = (i << 11) | (j << 6) | ((i + j) & 0x1F);
+    }
+  }
+
+  resetBusStats();
+  benchBegin();
+  for (t = 0; t < 16; t++) {
+    for (i = 0; i < 32; i++) {
+      for (j = 0; j < 32; j++) {
+        drawPixel((t & 3) * 32 + i, (t >> 2) * 32 + j, tile[i + j * 32]);
+      }
+    }
+  }
+  flush();
+  us = benchElapsedUs();
+  bytes = busBytes();
+  Report("RGB565 per pixel: %lu us, %lu bytes\n\r", us, bytes);
+
+  resetBusStats();
+  benchBegin();
+  for (t = 0; t < 16; t++) {
+    drawRGBBitmap((t & 3) * 32, (t >> 2) * 32, tile, 32, 32, 32, 0, 0);
+  }
+  flush();
+  us = benchElapsedUs();
+  bytes = busBytes();
+  Report("RGB565 blit: %lu us, %lu bytes\n\r", us, bytes);
+}
+
+// The tank drawn from primitives, as a masked sprite and as an opaque
+// sprite, for each of the n direction frames (index = direction / 45)
+void benchSprites(const SpriteFrame *frames, int n) {
+  static const int cannon[8][2] = {{12, 0}, {12, -12}, {0, -12}, {-12, -12},
+                                   {-12, 0}, {-12, 12}, {0, 12}, {12, 12}};
+  unsigned long usPrim, usSprite, usOpaque;
+  unsigned long bytesPrim, bytesSprite, bytesOpaque;
+  int i, k;
+
+  fillScreen(BLACK);
+  flush();
+  for (i = 0; i < n && i < 8; i++) {
+    resetBusStats();
+    benchBegin();
+    for (k = 0; k < 16; k++) {
+      drawCircle(64, 64, 6, GREEN);
+      drawLine(64, 64, 64 + cannon[i][0], 64 + cannon[i][1], GREEN);
+    }
+    flush();
+    usPrim = benchElapsedUs();
+    bytesPrim = busBytes();
+
+    resetBusStats();
+    benchBegin();
+    for (k = 0; k < 16; k++) {
+      spriteDraw(&frames[i], 64, 64);
+    }
+    flush();
+    usSprite = benchElapsedUs();
+    bytesSprite = busBytes();
+
+    resetBusStats();
+    benchBegin();
+    for (k = 0; k < 16; k++) {
+      spriteDrawOpaque(&frames[i], 64, 64, BLACK);
+    }
+    flush();
+    usOpaque = benchElapsedUs();
+    bytesOpaque = busBytes();
+
+    Report("frame %d (%dx%d, %u bytes), 16 draws: primitives %lu us %lu bytes, "
+           "sprite %lu us %lu bytes, opaque %lu us %lu bytes\n\r",
+           i, frames[i].w, frames[i].h, spriteFrameBytes(&frames[i]),
+           usPrim, bytesPrim, usSprite, bytesSprite, usOpaque, bytesOpaque);
+  }
+}
+
+// Projectile trails fanning out from the middle of a playfield clipped below
+// the score row; most of each trail, and all of the far ones, is outside it
+static unsigned long clipRun(int perPixel, int reach, unsigned int color) {
+  int i, dx, dy;
+
+  benchBegin();
+  for (i = 0; i < 64; i++) {
+    dx = (i % 16) * 16 - 120;
+    dy = (i / 16) * 80 - 120;
+    if (perPixel) {
+      drawLinePixels(64 + dx, 64 + dy, 64 + dx * reach, 64 + dy * reach, color);
+    } else {
+      drawLine(64 + dx, 64 + dy, 64 + dx * reach, 64 + dy * reach, color);
+    }
+  }
+  flush();
+  return benchElapsedUs();
+}
+
+void benchClipping(void) {
+  static const int reaches[] = {2, 4, 16};
+  unsigned long usPixels, usClipped, bytesPixels, bytesClipped;
+  unsigned int i;
+
+  fillScreen(BLACK);
+  flush();
+  pushClipRect(0, 10, 128, 118);
+  for (i = 0; i < sizeof(reaches)/sizeof(reaches[0]); i++) {
+    resetBusStats();
+    usPixels = clipRun(1, reaches[i], YELLOW);
+    bytesPixels = busBytes();
+
+    resetBusStats();
+    usClipped = clipRun(0, reaches[i], CYAN);
+    bytesClipped = busBytes();
+
+    Report("64 trails x%d: per pixel %lu us %lu bytes, clipped %lu us %lu bytes\n\r",
+           reaches[i], usPixels, bytesPixels, usClipped, bytesClipped);
+  }
+  popClipRect();
+}
+
+// One frame of the game from scratch: score line, tank, projectiles in
+// flight and the target
+static void gameScene(int scan, const SpriteFrame *tank) {
+  static const int shots[5][2] = {{80, 40}, {96, 28}, {20, 90}, {40, 110}, {110, 70}};
+  int i;
+
+  if (scan) {
+    scanBegin(BLACK);
+    scanString(0, 0, "Score: 12", 9, WHITE, BLACK, 1);
+    scanSprite(tank, 64, 64);
+    for (i = 0; i < 5; i++) {
+      scanCircle(shots[i][0], shots[i][1], 3, WHITE);
+    }
+    scanFillCircle(100, 100, 4, RED);
+    scanEnd();
+  } else {
+    fillScreen(BLACK);
+    drawString(0, 0, "Score: 12", 9, WHITE, BLACK, 1);
+    spriteDraw(tank, 64, 64);
+    for (i = 0; i < 5; i++) {
+      drawCircle(shots[i][0], shots[i][1], 3, WHITE);
+    }
+    fillCircle(100, 100, 4, RED);
+  }
+  flush();
+}
+
+void benchScanline(const SpriteFrame *tank) {
+  ScanlineStats stats;
+  unsigned long usDirect, usScan, bytesDirect, bytesScan;
+
+  resetBusStats();
+  benchBegin();
+  gameScene(0, tank);
+  usDirect = benchElapsedUs();
+  bytesDirect = busBytes();
+
+  resetBusStats();
+  benchBegin();
+  gameScene(1, tank);
+  usScan = benchElapsedUs();
+  bytesScan = busBytes();
+  getScanlineStats(&stats);
+
+  Report("game frame: direct %lu us %lu bytes, scanline %lu us %lu bytes "
+         "(%lu shapes, %u bytes of RAM)\n\r",
+         usDirect, bytesDirect, usScan, bytesScan, stats.shapes, stats.ramBytes);
+}
+
+// frames[0] turned on the fly against the pre-rendered frame of each
+// direction, both drawn opaque through one window
+void benchRotozoom(const SpriteFrame *frames, int n) {
+  unsigned long usFrame, usRotated, bytesFrame, bytesRotated;
+  int i, k;
+
+  fillScreen(BLACK);
+  flush();
+  for (i = 0; i < n && i < 8; i++) {
+    resetBusStats();
+    benchBegin();
+    for (k = 0; k < 16; k++) {
+      spriteDrawOpaque(&frames[i], 64, 64, BLACK);
+    }
+    flush();
+    usFrame = benchElapsedUs();
+    bytesFrame = busBytes();
+
+    resetBusStats();
+    benchBegin();
+    for (k = 0; k < 16; k++) {
+      spriteDrawRotated(&frames[0], 64, 64, i * 45, 65536, BLACK);
+    }
+    flush();
+    usRotated = benchElapsedUs();
+    bytesRotated = busBytes();
+
+    Report("%d deg, 16 draws: pre-rendered %lu us %lu bytes, "
+           "rotated %lu us %lu bytes\n\r",
+           i * 45, usFrame, bytesFrame, usRotated, bytesRotated);
+  }
+
+  // angles no pre-rendered frame has, and a zoom
+  resetBusStats();
+  benchBegin();
+  for (k = 0; k < 360; k += 5) {
+    spriteDrawRotated(&frames[0], 64, 64, k, 65536, BLACK);
+  }
+  flush();
+  usRotated = benchElapsedUs();
+  Report("72 angles: %lu us, %lu bytes\n\r", usRotated, busBytes());
+
+  resetBusStats();
+  benchBegin();
+  spriteDrawRotated(&frames[0], 64, 64, 30, 2 * 65536, BLACK);
+  flush();
+  usRotated = benchElapsedUs();
+  Report("30 deg at 2x: %lu us, %lu bytes\n\r", usRotated, busBytes());
+}
+
+// Tank facing right, hull, tracks and barrel in one outline, about its centre
+static const PolyPoint tankOutline[] = {
+  {-8, -7}, {6, -7}, {6, -4}, {3, -4}, {3, -1}, {13, -1}, {13, 1}, {3, 1},
+  {3, 4}, {6, 4}, {6, 7}, {-8, 7}, {-8, 4}, {-5, 4}, {-5, -4}, {-8, -4}
+};
+
+// An octagon around x, y, as a polygon or as a fan of fillTriangle()s
+static const PolyPoint octagon[] = {
+  {-20, -50}, {20, -50}, {50, -20}, {50, 20},
+  {20, 50}, {-20, 50}, {-50, 20}, {-50, -20}
+};
+
+static void polygonRun(const char *name, const PolyPoint *points, int n,
+                       int fan) {
+  PolygonStats stats;
+  unsigned long us;
+  int i;
+
+  fillScreen(BLACK);
+  flush();
+  resetPolygonStats();
+  resetBusStats();
+  benchBegin();
+  if (fan) {
+    for (i = 1; i + 1 < n; i++) {
+      fillTriangle(64 + points[0].x, 64 + points[0].y,
+                   64 + points[i].x, 64 + points[i].y,
+                   64 + points[i+1].x, 64 + points[i+1].y, YELLOW);
+    }
+  } else {
+    fillPolygon(64, 64, points, n, YELLOW);
+  }
+  flush();
+  us = benchElapsedUs();
+  getPolygonStats(&stats);
+
+  if (fan) {
+    Report("%s: %lu us %lu bytes\n\r", name, us, busBytes());
+  } else {
+    Report("%s: %lu us %lu bytes, %lu px in %lu rects (%lu rows), "
+           "%lu px/ms\n\r", name, us, busBytes(), stats.pixels, stats.rects,
+           stats.rows, us ? stats.pixels * 1000 / us : 0);
+  }
+}
+
+void benchPolygonFill(void) {
+  polygonRun("octagon, fillTriangle fan", octagon, 8, 1);
+  polygonRun("octagon, fillPolygon", octagon, 8, 0);
+  polygonRun("tank outline, fillPolygon", tankOutline,
+             sizeof(tankOutline)/sizeof(tankOutline[0]), 0);
+}
+
+// The tank crossing the title art, erased by redrawing the art under it
+// (clipped to the tank's box) or by putting back what it covered
+static unsigned long saveUnderRun(int restore, const SpriteFrame *tank,
+                                  const unsigned char *art, int w, int h) {
+  SaveUnder under;
+  int k, x = 10, y = 30, px = 0, py = 0;
+  const SpriteFrame *f, *pf = 0;
+
+  fillScreen(BLACK);
+  drawXBitmap(0, 0, art, w, h, WHITE);
+  flush();
+  resetBusStats();
+  resetSaveUnderStats();
+  under.active = 0;
+
+  benchBegin();
+  for (k = 0; k < 32; k++) {
+    f = &tank[k % 8];
+    if (restore) {
+      restoreUnder(&under, BLACK);
+    } else if (pf) {
+      pushClipRect(px + pf->ox, py + pf->oy, pf->w, pf->h);
+      fillScreen(BLACK);
+      drawXBitmap(0, 0, art, w, h, WHITE);
+      popClipRect();
+    }
+    if (restore) saveUnder(&under, x + f->ox, y + f->oy, f->w, f->h);
+    spriteDraw(f, x, y);
+    flush();
+    pf = f;
+    px = x;
+    py = y;
+    x += 3;
+    y += 2;
+  }
+  return benchElapsedUs();
+}
+
+void benchSaveUnder(const SpriteFrame *tank, const unsigned char *art,
+                    int w, int h) {
+  SaveUnderStats stats;
+  unsigned long usRedraw, usRestore, bytesRedraw;
+
+  usRedraw = saveUnderRun(0, tank, art, w, h);
+  bytesRedraw = busBytes();
+  usRestore = saveUnderRun(1, tank, art, w, h);
+  getSaveUnderStats(&stats);
+
+  Report("32 tank moves over art: redraw art %lu us %lu bytes, "
+         "save-under %lu us %lu bytes (%lu px restored, %lu fell back)\n\r",
+         usRedraw, bytesRedraw, usRestore, busBytes(),
+         stats.pixelsRestored, stats.fallbacks);
+}
+
+// The static part of an arena: walls, a pillar, a pond and the score label
+static void arenaStatic(void) {
+  scanFillRect(0, 10, 128, 2, CYAN);
+  scanFillRect(0, 126, 128, 2, CYAN);
+  scanFillRect(0, 10, 2, 118, CYAN);
+  scanFillRect(126, 10, 2, 118, CYAN);
+  scanFillRect(60, 50, 8, 28, CYAN);
+  scanFillCircle(30, 100, 10, BLUE);
+  scanString(0, 0, "Score:", 6, WHITE, WHITE, 1);
+}
+
+// The tank and n - 1 projectiles in flight, frame f
+static void arenaObjects(const SpriteFrame *tank, int n, int f) {
+  int i;
+
+  for (i = 1; i < n; i++) {
+    scanCircle(8 + (i * 37 + f * (2 + i % 3)) % 112,
+               16 + (i * 23 + f * (3 - i % 3)) % 104, 3, WHITE);
+  }
+  scanSprite(tank, 24 + f * 2, 40 + f);
+}
+
+// 16 frames with 1 to 16 moving objects over a static arena: composited
+// against the whole frame rendered by the scanline renderer every time
+void benchLayers(const SpriteFrame *tank) {
+  LayerStats stats;
+  unsigned long usFull, usLayers, bytesFull, pixels;
+  int n, f;
+
+  layerStaticBegin(BLACK);
+  arenaStatic();
+  if (layerStaticEnd()) {
+    getLayerStats(&stats);
+    Report("static layer: %u runs, %u bytes cached\n\r",
+           stats.staticRuns, stats.staticRuns * 4);
+  } else {
+    Report("static layer: too big to cache, rendered in every box\n\r");
+  }
+  flush();
+
+  for (n = 1; n <= 16; n *= 2) {
+    resetBusStats();
+    benchBegin();
+    for (f = 0; f < 16; f++) {
+      scanBegin(BLACK);
+      arenaStatic();
+      arenaObjects(tank, n, f);
+      scanEnd();
+      flush();
+    }
+    usFull = benchElapsedUs();
+    bytesFull = busBytes();
+
+    layerStaticBegin(BLACK);
+    arenaStatic();
+    layerStaticEnd();
+    flush();
+    pixels = 0;
+    resetBusStats();
+    benchBegin();
+    for (f = 0; f < 16; f++) {
+      layerFrameBegin();
+      arenaObjects(tank, n, f);
+      layerFrameEnd();
+      flush();
+      getLayerStats(&stats);
+      pixels += stats.pixelsComposited;
+    }
+    usLayers = benchElapsedUs();
+
+    Report("%2d objects, 16 frames: full %lu us %lu bytes, "
+           "layered %lu us %lu bytes (%lu px a frame)\n\r",
+           n, usFull, bytesFull, usLayers, busBytes(), pixels / 16);
+  }
+}
+
+// Every benchmark in turn: tank is the 8 direction frames, art the title
+// page XBM. main() runs it before the game when built with OLED_BENCH.
+void runBenchmarks(const SpriteFrame *tank, const unsigned char *art,
+                   int w, int h) {
+  Report("benchmarks\n\r");
+  benchWindowCache();
+  benchPixelThroughput();
+  benchFillRate();
+  benchCircles();
+  benchCircleTables();
+  benchLineSlopes();
+  benchGlyphCache();
+  benchScoreField();
+  benchTitlePage(art, w, h);
+  benchRGBBitmap();
+  benchSprites(tank, 8);
+  benchClipping();
+  benchScanline(tank);
+  benchRotozoom(tank, 8);
+  benchPolygonFill();
+  benchSaveUnder(tank, art, w, h);
+  benchLayers(tank);
+
+  fillScreen(BLACK);
+  flush();
+}
@@ -8,6 +8,8 @@
 #ifndef OLED_OLED_TEST_H_
 #define OLED_OLED_TEST_H_
 
+#include "sprite.h"
+
 // Color definitions
 #define BLACK           0x0000
 #define BLUE            0x001F
@@ -30,5 +32,25 @@ void testlines(unsigned int color);
 void lcdTestPattern(void);
 void lcdTestPattern2(void);
 
+void benchWindowCache(void);
+void benchPixelThroughput(void);
+void benchFillRate(void);
+void benchCircles(void);
+void benchCircleTables(void);
+void benchLineSlopes(void);
+void benchGlyphCache(void);
+void benchScoreField(void);
+void benchTitlePage(const unsigned char *art, int w, int h);
+void benchRGBBitmap(void);
+void benchSprites(const SpriteFrame *frames, int n);
+void benchClipping(void);
+void benchScanline(const SpriteFrame *tank);
+void benchRotozoom(const SpriteFrame *frames, int n);
+void benchPolygonFill(void);
+void benchSaveUnder(const SpriteFrame *tank, const unsigned char *art, int w, int h);
+void benchLayers(const SpriteFrame *tank);
+void runBenchmarks(const SpriteFrame *tank, const unsigned char *art,
+                   int w, int h);
+
 
 #endif /* OLED_OLED_TEST_H_ */
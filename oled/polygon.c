@@ -0,0 +1,177 @@
+/*
+ * polygon.c
+ *
+ * fillPolygon() is a classic edge table / active edge list scan converter.
+ * The polygon's non-horizontal edges are sorted by their top row; going
+ * down, an edge joins the active list at its top row and leaves at its
+ * bottom row. The active edges are kept sorted by x and filled between
+ * pairs (even-odd rule), so concave and self-crossing outlines work.
+ *
+ * Rows are sampled at integer y and spans run from ceil(x) of the left edge
+ * to ceil(x) - 1 of the right one, so a polygon covers the pixels whose
+ * top left corner lies inside it: the square (0,0) (4,0) (4,4) (0,4) fills
+ * 4x4 pixels, and polygons sharing an edge neither overlap nor leave a gap.
+ * Each edge steps its x as an integer plus a remainder over its height, so
+ * the spans are exact however long the edge.
+ *
+ * The spans of one row are held until a row with different spans comes
+ * along; until then each following identical row just makes them one row
+ * taller. They go out through fillRect(), and so are clipped, recorded in
+ * the display list or written to the framebuffer like any other fill.
+ */
+
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+#include "Adafruit_GFX.h"
+#include "polygon.h"
+
+typedef struct {
+  int top, bottom;   // rows top..bottom-1
+  int x, rem;        // x on the current row is x + rem/dy
+  int step, stepRem; // x += step + stepRem/dy per row
+  int dy;
+} PolyEdge;
+
+typedef struct {
+  int x0, x1;        // columns x0..x1-1
+} PolySpan;
+
+static PolygonStats polyStats;
+
+// floor(a / b) for b > 0
+static int floorDiv(int a, int b) {
+  return a >= 0 ? a / b : -((b - 1 - a) / b);
+}
+
+// Puts e at row y of its edge from (x0, y0) to (x1, y1)
+static void edgeAt(PolyEdge *e, int x0, int y0, int x1, int y1, int y) {
+  int num = (y - y0) * (x1 - x0);
+
+  e->dy = y1 - y0;
+  e->x = x0 + floorDiv(num, e->dy);
+  e->rem = num - floorDiv(num, e->dy) * e->dy;
+  e->step = floorDiv(x1 - x0, e->dy);
+  e->stepRem = (x1 - x0) - e->step * e->dy;
+}
+
+static int edgeCeil(const PolyEdge *e) {
+  return e->x + (e->rem > 0);
+}
+
+static void sendSpans(const PolySpan *spans, int n, int y, int h,
+                      unsigned int color) {
+  int i;
+
+  for (i = 0; i < n; i++) {
+    fillRect(spans[i].x0, y, spans[i].x1 - spans[i].x0, h, color);
+    polyStats.rects++;
+    polyStats.pixels += (unsigned long)(spans[i].x1 - spans[i].x0) * h;
+  }
+}
+
+// The polygon with corners x + points[i].x, y + points[i].y, in order
+void fillPolygon(int x, int y, const PolyPoint *points, int n,
+                 unsigned int color) {
+  PolyEdge edges[POLY_MAX_POINTS];      // edge table, by top row
+  PolyEdge *active[POLY_MAX_POINTS];    // active edges, by x
+  PolySpan spans[2][POLY_MAX_POINTS / 2];
+  int numEdges = 0, numActive = 0, next = 0, numSpans = 0, pending = 0;
+  int cur = 0, pendingY = 0, pendingH = 0;
+  int i, j, row, x0, y0, x1, y1, cx0, cy0, cx1, cy1;
+  PolyEdge edge, *e;
+
+  if (n < 3 || n > POLY_MAX_POINTS) return;
+  polyStats.polygons++;
+  getClipRect(&cx0, &cy0, &cx1, &cy1);
+
+  for (i = 0; i < n; i++) {
+    x0 = x + points[i].x;
+    y0 = y + points[i].y;
+    x1 = x + points[(i + 1) % n].x;
+    y1 = y + points[(i + 1) % n].y;
+    if (y0 == y1) continue;
+    if (y0 > y1) {
+      swap(x0, x1);
+      swap(y0, y1);
+    }
+    if (y1 <= cy0 || y0 > cy1) continue;
+
+    // rows above the clip rectangle are skipped, not stepped through
+    edgeAt(&edge, x0, y0, x1, y1, y0 > cy0 ? y0 : cy0);
+    edge.top = y0 > cy0 ? y0 : cy0;
+    edge.bottom = y1;
+    for (j = numEdges++; j > 0 && edges[j-1].top > edge.top; j--) {
+      edges[j] = edges[j-1];
+    }
+    edges[j] = edge;
+  }
+  if (numEdges == 0) return;
+
+  startWrite();
+  for (row = edges[0].top; row <= cy1; row++) {
+    // edges ending here leave, edges starting here join
+    for (i = 0, j = 0; i < numActive; i++) {
+      if (active[i]->bottom > row) active[j++] = active[i];
+    }
+    numActive = j;
+    for (; next < numEdges && edges[next].top == row; next++) {
+      active[numActive++] = &edges[next];
+    }
+    if (numActive == 0 && next == numEdges) break;
+
+    // insertion sort: the order barely changes from row to row
+    for (i = 1; i < numActive; i++) {
+      e = active[i];
+      for (j = i; j > 0 && edgeCeil(active[j-1]) > edgeCeil(e); j--) {
+        active[j] = active[j-1];
+      }
+      active[j] = e;
+    }
+
+    numSpans = 0;
+    for (i = 0; i + 1 < numActive; i += 2) {
+      x0 = edgeCeil(active[i]);
+      x1 = edgeCeil(active[i+1]);
+      if (x0 < x1) {
+        spans[cur ^ 1][numSpans].x0 = x0;
+        spans[cur ^ 1][numSpans].x1 = x1;
+        numSpans++;
+      }
+    }
+    if (numSpans) polyStats.rows++;
+    polyStats.spans += numSpans;
+
+    // same spans as the rows held back: they just get taller
+    if (numSpans == pending && pendingH &&
+        memcmp(spans[cur], spans[cur ^ 1], numSpans * sizeof(PolySpan)) == 0) {
+      pendingH++;
+    } else {
+      sendSpans(spans[cur], pending, pendingY, pendingH, color);
+      cur ^= 1;
+      pending = numSpans;
+      pendingY = row;
+      pendingH = 1;
+    }
+
+    for (i = 0; i < numActive; i++) {
+      e = active[i];
+      e->x += e->step;
+      e->rem += e->stepRem;
+      if (e->rem >= e->dy) {
+        e->x++;
+        e->rem -= e->dy;
+      }
+    }
+  }
+  sendSpans(spans[cur], pending, pendingY, pendingH, color);
+  endWrite();
+}
+
+void getPolygonStats(PolygonStats *stats) {
+  *stats = polyStats;
+}
+
+void resetPolygonStats(void) {
+  memset(&polyStats, 0, sizeof(polyStats));
+}
@@ -0,0 +1,32 @@
+/*
+ * polygon.h
+ *
+ * Filled polygons, convex or not, drawn as horizontal spans. Rows whose
+ * spans match the row above are merged into one rectangle, so straight
+ * sided parts of a polygon go out as a single window.
+ */
+
+#ifndef OLED_POLYGON_H_
+#define OLED_POLYGON_H_
+
+// Corners a polygon can have
+#define POLY_MAX_POINTS 32
+
+typedef struct {
+  short x, y;
+} PolyPoint;
+
+typedef struct {
+  unsigned long polygons;
+  unsigned long rows;      // rows with at least one span
+  unsigned long spans;
+  unsigned long rects;     // fillRect calls after merging rows
+  unsigned long pixels;
+} PolygonStats;
+
+void fillPolygon(int x, int y, const PolyPoint *points, int n,
+                 unsigned int color);
+void getPolygonStats(PolygonStats *stats);
+void resetPolygonStats(void);
+
+#endif /* OLED_POLYGON_H_ */
@@ -0,0 +1,119 @@
+/*
+ * save_under.c
+ *
+ * saveUnder() copies a rectangle of the framebuffer into a pool before
+ * something is drawn over it; restoreUnder() writes it back through one
+ * window, so erasing costs the object's area whatever the background is.
+ *
+ * The pool is a stack: a save takes the space above the newest one still
+ * held, and space is given back once every save above it is restored too.
+ * Restoring in the reverse order of saving (take everything off, move,
+ * then save and draw everything again) keeps overlapping objects right and
+ * the pool compact; a save held over many frames, like a target, sits at
+ * the bottom.
+ *
+ * Without a framebuffer the panel cannot be read back, and a save whose
+ * pixels do not fit the pool keeps only its rectangle: restoreUnder() then
+ * fills the rectangle with the background colour, as the game erased
+ * before.
+ */
+
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+#include "save_under.h"
+
+typedef struct {
+  unsigned int offset, bytes;
+  char live;
+} SaveBlock;
+
+#ifdef SSD1351_FRAMEBUFFER
+static unsigned char pool[SAVE_UNDER_BYTES];
+static SaveBlock blocks[SAVE_UNDER_SLOTS];
+static int numBlocks = 0;
+
+// A block of bytes at the top of the pool; -1 if there is no room
+static int takeBlock(unsigned int bytes) {
+  unsigned int top = numBlocks ? blocks[numBlocks-1].offset +
+                                 blocks[numBlocks-1].bytes : 0;
+
+  if (numBlocks == SAVE_UNDER_SLOTS || top + bytes > SAVE_UNDER_BYTES) {
+    return -1;
+  }
+  blocks[numBlocks].offset = top;
+  blocks[numBlocks].bytes = bytes;
+  blocks[numBlocks].live = 1;
+  return numBlocks++;
+}
+
+static void giveBlock(int slot) {
+  blocks[slot].live = 0;
+  while (numBlocks && !blocks[numBlocks-1].live) numBlocks--;
+}
+#endif
+
+static SaveUnderStats saveStats;
+
+// Saves what is under the w x h rectangle at x, y
+void saveUnder(SaveUnder *s, int x, int y, int w, int h) {
+#ifdef SSD1351_FRAMEBUFFER
+  unsigned char *dst;
+  int row, rowBytes;
+#endif
+
+  s->x0 = x;
+  s->y0 = y;
+  s->x1 = x + w - 1;
+  s->y1 = y + h - 1;
+  s->slot = -1;
+  s->active = w > 0 && h > 0 && clipRect(&s->x0, &s->y0, &s->x1, &s->y1);
+  if (!s->active) return;
+  saveStats.saves++;
+
+#ifdef SSD1351_FRAMEBUFFER
+  rowBytes = 2 * (s->x1 - s->x0 + 1);
+  s->slot = takeBlock(rowBytes * (s->y1 - s->y0 + 1));
+  if (s->slot < 0) return;
+
+  dst = pool + blocks[s->slot].offset;
+  for (row = s->y0; row <= s->y1; row++) {
+    memcpy(dst, &frameBuffer[row][s->x0], rowBytes);
+    dst += rowBytes;
+  }
+#endif
+}
+
+// Puts back what saveUnder() kept, or fills with bg if the pixels were not
+// kept; does nothing the second time
+void restoreUnder(SaveUnder *s, unsigned int bg) {
+  unsigned long pixels;
+
+  if (!s->active) return;
+  s->active = 0;
+  pixels = (unsigned long)(s->x1 - s->x0 + 1) * (s->y1 - s->y0 + 1);
+  saveStats.restores++;
+  saveStats.pixelsRestored += pixels;
+
+#ifdef SSD1351_FRAMEBUFFER
+  if (s->slot >= 0) {
+    startWrite();
+    setAddrWindow(s->x0, s->y0, s->x1, s->y1);
+    pushPixels(pool + blocks[s->slot].offset, pixels);
+    endWrite();
+    giveBlock(s->slot);
+    return;
+  }
+#endif
+
+  saveStats.fallbacks++;
+  fillRect(s->x0, s->y0, s->x1 - s->x0 + 1, s->y1 - s->y0 + 1, bg);
+}
+
+void getSaveUnderStats(SaveUnderStats *stats) {
+  *stats = saveStats;
+}
+
+void resetSaveUnderStats(void) {
+  memset(&saveStats, 0, sizeof(saveStats));
+}
@@ -0,0 +1,37 @@
+/*
+ * save_under.h
+ *
+ * Keeps the pixels a moving object covers so that taking it away puts back
+ * what was underneath, instead of painting the background colour over it.
+ */
+
+#ifndef OLED_SAVE_UNDER_H_
+#define OLED_SAVE_UNDER_H_
+
+// Bytes of saved pixels held at once, 2 per pixel
+#ifndef SAVE_UNDER_BYTES
+#define SAVE_UNDER_BYTES 2048
+#endif
+
+// Saves held at once
+#define SAVE_UNDER_SLOTS 16
+
+typedef struct {
+  int x0, y0, x1, y1;      // saved rectangle, inclusive, clipped
+  signed char slot;        // pool slot, -1 if only the rectangle is kept
+  char active;             // saved and not yet restored
+} SaveUnder;
+
+typedef struct {
+  unsigned long saves;
+  unsigned long restores;
+  unsigned long fallbacks;       // restores that filled with bg instead
+  unsigned long pixelsRestored;
+} SaveUnderStats;
+
+void saveUnder(SaveUnder *s, int x, int y, int w, int h);
+void restoreUnder(SaveUnder *s, unsigned int bg);
+void getSaveUnderStats(SaveUnderStats *stats);
+void resetSaveUnderStats(void);
+
+#endif /* OLED_SAVE_UNDER_H_ */
@@ -0,0 +1,557 @@
+/*
+ * scanline.c
+ *
+ * scanBegin() opens a frame; the scan* calls add shapes to it instead of
+ * drawing, and scanEnd() renders it. Shapes are kept in the order they were
+ * added and indexed by their top row. Going down the clip rectangle, a shape
+ * joins the active list at its top row and leaves after its bottom row; each
+ * row is cleared to the frame's background, every active shape writes its
+ * spans on that row in the order the shapes were added (so later shapes
+ * cover earlier ones, as when drawing directly), and the row is sent with
+ * pushPixels() into the one window opened for the frame.
+ *
+ * scanRender() does the same without ending the frame, and can take each
+ * row's starting pixels from a backdrop hook and give the finished rows to
+ * a sink hook instead of the panel; layers.c builds its compositor on it.
+ * scanMark() remembers how far the list has got and scanRewind() drops the
+ * shapes added since, so shapes common to several frames are added once.
+ *
+ * Nothing is copied from the shapes' data: strings, bitmaps and sprite
+ * frames must stay valid until scanEnd(). Circles keep their row spans in a
+ * small pool, computed once when they are added.
+ *
+ * Lines, circles, text and bitmaps cover exactly the pixels drawLine(),
+ * drawCircle(), fillCircle(), drawString(), drawXBitmap(), drawRGBBitmap()
+ * and spriteDraw() would.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "Adafruit_SSD1351.h"
+#include "Adafruit_GFX.h"
+#include "display_list.h"
+#include "glyph_cache.h"
+#include "scanline.h"
+
+#define SCAN_RECT        0
+#define SCAN_LINE        1   // shallow: one run per row
+#define SCAN_STEEP_LINE  2   // one pixel per row
+#define SCAN_CIRCLE      3
+#define SCAN_FILL_CIRCLE 4
+#define SCAN_TEXT        5
+#define SCAN_XBM         6
+#define SCAN_RGB         7
+#define SCAN_SPRITE      8
+
+typedef struct {
+  unsigned char type;
+  unsigned char size;          // text size, number of colour keys
+  short top, bottom;           // rows covered, inclusive
+  short x0, y0, x1, y1;        // see the scan* call of each type
+  unsigned short color, bg;
+  const void *data;
+  const unsigned int *keys;
+} ScanShape;
+
+static ScanShape shapes[SCAN_MAX_SHAPES];
+static unsigned char byTop[SCAN_MAX_SHAPES];   // shape indices, by top row
+static unsigned char active[SCAN_MAX_SHAPES];  // shape indices, in order
+static unsigned char spanPool[SCAN_SPAN_BYTES];
+static unsigned char line[2 * SSD1351WIDTH];
+static unsigned int numShapes = 0;
+static unsigned int spanUsed = 0;
+static unsigned int markShapes = 0, markSpans = 0;
+static unsigned int scanBg = 0;
+static ScanlineStats scanStats;
+
+void scanBegin(unsigned int bg) {
+  memset(&scanStats, 0, sizeof(scanStats));
+  numShapes = 0;
+  spanUsed = 0;
+  markShapes = markSpans = 0;
+  scanBg = bg;
+}
+
+// Adds a shape covering rows top..bottom; 0 if the list is full
+static ScanShape *addShape(unsigned char type, int top, int bottom) {
+  ScanShape *s;
+  int cx0, cy0, cx1, cy1;
+  unsigned int i;
+
+  getClipRect(&cx0, &cy0, &cx1, &cy1);
+  if (bottom < cy0 || top > cy1) return 0;
+  if (numShapes == SCAN_MAX_SHAPES) {
+    scanStats.shapesDropped++;
+    return 0;
+  }
+
+  s = &shapes[numShapes];
+  s->type = type;
+  s->top = top;
+  s->bottom = bottom;
+
+  // after the shapes with the same top, so ties stay in order
+  for (i = numShapes; i > 0 && shapes[byTop[i-1]].top > top; i--) {
+    byTop[i] = byTop[i-1];
+  }
+  byTop[i] = numShapes++;
+  return s;
+}
+
+// Takes n bytes of the span pool; 0 if it is full
+static unsigned char *takeSpans(int n) {
+  unsigned char *p;
+
+  if (spanUsed + n > SCAN_SPAN_BYTES) {
+    scanStats.shapesDropped++;
+    return 0;
+  }
+  p = spanPool + spanUsed;
+  spanUsed += n;
+  return p;
+}
+
+int scanFillRect(int x, int y, int w, int h, unsigned int color) {
+  ScanShape *s;
+
+  if (w <= 0 || h <= 0) return 0;
+  s = addShape(SCAN_RECT, y, y + h - 1);
+  if (!s) return 0;
+  s->x0 = x;
+  s->x1 = x + w - 1;
+  s->color = color;
+  return 1;
+}
+
+// Stored as drawLine() walks it: x0..x1 along the major axis, y0 the minor
+// coordinate at x0 and y1 at x1
+int scanLine(int x0, int y0, int x1, int y1, unsigned int color) {
+  ScanShape *s;
+  int steep;
+
+  if (y0 == y1) {
+    if (x0 > x1) swap(x0, x1);
+    return scanFillRect(x0, y0, x1 - x0 + 1, 1, color);
+  }
+  if (x0 == x1) {
+    if (y0 > y1) swap(y0, y1);
+    return scanFillRect(x0, y0, 1, y1 - y0 + 1, color);
+  }
+
+  steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    swap(x0, y0);
+    swap(x1, y1);
+  }
+  if (x0 > x1) {
+    swap(x0, x1);
+    swap(y0, y1);
+  }
+
+  if (steep) {
+    s = addShape(SCAN_STEEP_LINE, x0, x1);
+  } else {
+    s = addShape(SCAN_LINE, y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0);
+  }
+  if (!s) return 0;
+  s->x0 = x0;
+  s->y0 = y0;
+  s->x1 = x1;
+  s->y1 = y1;
+  s->color = color;
+  return 1;
+}
+
+int scanCircle(int x0, int y0, int r, unsigned int color) {
+  ScanShape *s;
+  unsigned char *spans;
+
+  if (r < 0 || r >= SSD1351WIDTH) return 0;
+  spans = takeSpans(2 * (r + 1));
+  if (!spans) return 0;
+  s = addShape(SCAN_CIRCLE, y0 - r, y0 + r);
+  if (!s) {
+    spanUsed -= 2 * (r + 1);
+    return 0;
+  }
+  circleOutlineSpans(r, spans, spans + r + 1);
+  s->x0 = x0;
+  s->y0 = y0;
+  s->x1 = r;
+  s->color = color;
+  s->data = spans;
+  return 1;
+}
+
+int scanFillCircle(int x0, int y0, int r, unsigned int color) {
+  ScanShape *s;
+  unsigned char *spans;
+
+  if (r < 0 || r >= SSD1351WIDTH) return 0;
+  spans = takeSpans(r + 1);
+  if (!spans) return 0;
+  s = addShape(SCAN_FILL_CIRCLE, y0 - r, y0 + r);
+  if (!s) {
+    spanUsed -= r + 1;
+    return 0;
+  }
+  circleFillSpans(r, spans);
+  s->x0 = x0;
+  s->y0 = y0;
+  s->x1 = r;
+  s->color = color;
+  s->data = spans;
+  return 1;
+}
+
+// n characters of str on one line, opaque unless bg == color
+int scanString(int x, int y, const char *str, int n,
+               unsigned int color, unsigned int bg, unsigned char size) {
+  ScanShape *s;
+
+  if (n <= 0 || size == 0) return 0;
+  s = addShape(SCAN_TEXT, y, y + 8*size - 1);
+  if (!s) return 0;
+  s->x0 = x;
+  s->y0 = y;
+  s->x1 = n;
+  s->size = size;
+  s->color = color;
+  s->bg = bg;
+  s->data = str;
+  return 1;
+}
+
+int scanXBitmap(int x, int y, const unsigned char *bitmap, int w, int h,
+                unsigned int color) {
+  ScanShape *s;
+
+  if (w <= 0 || h <= 0) return 0;
+  s = addShape(SCAN_XBM, y, y + h - 1);
+  if (!s) return 0;
+  s->x0 = x;
+  s->y0 = y;
+  s->x1 = w;
+  s->color = color;
+  s->data = bitmap;
+  return 1;
+}
+
+int scanRGBBitmap(int x, int y, const unsigned int *pixels, int w, int h,
+                  int stride, const unsigned int *keys, int numKeys) {
+  ScanShape *s;
+
+  if (w <= 0 || h <= 0) return 0;
+  s = addShape(SCAN_RGB, y, y + h - 1);
+  if (!s) return 0;
+  s->x0 = x;
+  s->y0 = y;
+  s->x1 = w;
+  s->y1 = stride;
+  s->size = numKeys;
+  s->keys = keys;
+  s->data = pixels;
+  return 1;
+}
+
+int scanSprite(const SpriteFrame *f, int x, int y) {
+  ScanShape *s;
+
+  s = addShape(SCAN_SPRITE, y + f->oy, y + f->oy + f->h - 1);
+  if (!s) return 0;
+  s->x0 = x + f->ox;
+  s->y0 = y + f->oy;
+  s->data = f;
+  return 1;
+}
+
+//*****************************************************************************
+//
+// Row rendering. The row buffer holds columns clipX0..clipX1 of the current
+// row in panel byte order.
+//
+//*****************************************************************************
+static int clipX0, clipX1;
+
+static void span(int x0, int x1, unsigned int color) {
+  unsigned char *p;
+  unsigned char hi = color >> 8, lo = color;
+  int x;
+
+  if (x0 < clipX0) x0 = clipX0;
+  if (x1 > clipX1) x1 = clipX1;
+  if (x0 > x1) return;
+
+  scanStats.spans++;
+  p = line + 2 * x0;
+  for (x = x0; x <= x1; x++) {
+    *p++ = hi;
+    *p++ = lo;
+  }
+}
+
+// Row y of a line; step k along the major axis is n(k) steps along the
+// minor one, n(k) = max(0, ceil((k*dy - dx/2)/dx)) as drawLine() counts it
+static void lineRow(const ScanShape *s, int y) {
+  int dx = s->x1 - s->x0;
+  int dy = abs(s->y1 - s->y0);
+  int e = dx / 2;
+  int k, n, first, last;
+
+  if (s->type == SCAN_STEEP_LINE) {
+    k = y - s->x0;
+    n = k * dy > e ? (k * dy - e + dx - 1) / dx : 0;
+    n = s->y1 > s->y0 ? s->y0 + n : s->y0 - n;
+    span(n, n, s->color);
+    return;
+  }
+
+  // the steps whose n(k) is this row's n
+  n = abs(y - s->y0);
+  first = n ? ((n - 1) * dx + e) / dy + 1 : 0;
+  last = (n * dx + e) / dy;
+  if (last > dx) last = dx;
+  span(s->x0 + first, s->x0 + last, s->color);
+}
+
+static void circleRow(const ScanShape *s, int y) {
+  const unsigned char *spans = (const unsigned char *)s->data;
+  int r = s->x1, dy = abs(y - s->y0);
+  int lo, hi;
+
+  if (s->type == SCAN_FILL_CIRCLE) {
+    span(s->x0 - spans[dy], s->x0 + spans[dy], s->color);
+    return;
+  }
+  lo = spans[dy];
+  hi = spans[r + 1 + dy];
+  if (lo > hi) return;
+  if (lo == 0) {
+    span(s->x0 - hi, s->x0 + hi, s->color);
+  } else {
+    span(s->x0 + lo, s->x0 + hi, s->color);
+    span(s->x0 - hi, s->x0 - lo, s->color);
+  }
+}
+
+static void textRow(const ScanShape *s, int y) {
+  const unsigned char *str = (const unsigned char *)s->data;
+  int size = s->size, opaque = s->color != s->bg;
+  int row = (y - s->y0) / size;
+  int i, col, x;
+  unsigned char bits;
+
+  for (i = 0; i < s->x1; i++) {
+    x = s->x0 + 6*size*i;
+    if (x > clipX1) break;
+    if (x + 6*size - 1 < clipX0) continue;
+
+    bits = glyphRowBits(str[i], row);
+    for (col = 0; col < 6; col++, x += size, bits >>= 1) {
+      if (bits & 0x1) {
+        span(x, x + size - 1, s->color);
+      } else if (opaque) {
+        span(x, x + size - 1, s->bg);
+      }
+    }
+  }
+}
+
+static void xbmRow(const ScanShape *s, int y) {
+  const unsigned char *row;
+  int from, to, col, start, len;
+
+  row = (const unsigned char *)s->data + (y - s->y0) * ((s->x1 + 7) / 8);
+  from = clipX0 > s->x0 ? clipX0 - s->x0 : 0;
+  to = clipX1 < s->x0 + s->x1 - 1 ? clipX1 - s->x0 + 1 : s->x1;
+  for (col = from; (len = xbmNextRun(row, col, to, &start)); col = start + len) {
+    span(s->x0 + start, s->x0 + start + len - 1, s->color);
+  }
+}
+
+static void rgbRow(const ScanShape *s, int y) {
+  const unsigned int *row;
+  unsigned int c;
+  int from, to, i, k;
+
+  row = (const unsigned int *)s->data + (y - s->y0) * s->y1;
+  from = clipX0 > s->x0 ? clipX0 - s->x0 : 0;
+  to = clipX1 < s->x0 + s->x1 - 1 ? clipX1 - s->x0 + 1 : s->x1;
+  if (from >= to) return;
+
+  scanStats.spans++;
+  for (i = from; i < to; i++) {
+    c = row[i];
+    for (k = 0; k < s->size && s->keys[k] != c; k++);
+    if (k < s->size) continue;
+    line[2*(s->x0 + i)]     = c >> 8;
+    line[2*(s->x0 + i) + 1] = c;
+  }
+}
+
+static void spriteRow(const ScanShape *s, int y) {
+  const SpriteFrame *f = (const SpriteFrame *)s->data;
+  const unsigned char *mask, *pixels;
+  int from, to, col, start, len, j = y - s->y0;
+
+  mask = f->mask + j * ((f->w + 7) / 8);
+  pixels = f->pixels + 2 * j * f->w;
+  from = clipX0 > s->x0 ? clipX0 - s->x0 : 0;
+  to = clipX1 < s->x0 + f->w - 1 ? clipX1 - s->x0 + 1 : f->w;
+  for (col = from; (len = xbmNextRun(mask, col, to, &start)); col = start + len) {
+    scanStats.spans++;
+    memcpy(line + 2 * (s->x0 + start), pixels + 2 * start, 2 * len);
+  }
+}
+
+static void shapeRow(const ScanShape *s, int y) {
+  switch (s->type) {
+  case SCAN_RECT:
+    span(s->x0, s->x1, s->color);
+    break;
+  case SCAN_LINE:
+  case SCAN_STEEP_LINE:
+    lineRow(s, y);
+    break;
+  case SCAN_CIRCLE:
+  case SCAN_FILL_CIRCLE:
+    circleRow(s, y);
+    break;
+  case SCAN_TEXT:
+    textRow(s, y);
+    break;
+  case SCAN_XBM:
+    xbmRow(s, y);
+    break;
+  case SCAN_RGB:
+    rgbRow(s, y);
+    break;
+  case SCAN_SPRITE:
+    spriteRow(s, y);
+    break;
+  }
+}
+
+// Renders the shapes inside the clip rectangle, starting each row from
+// backdrop (or the frame's background) and handing it to sink (or the
+// panel). The list is kept, so the frame can be rendered again elsewhere.
+void scanRender(ScanRowFn backdrop, ScanRowFn sink) {
+  int cy0, cy1, y;
+  unsigned int next = 0, numActive = 0, i, j;
+
+  scanStats.shapes = numShapes;
+  scanStats.ramBytes = sizeof(shapes) + sizeof(byTop) + sizeof(active) +
+                       sizeof(spanPool) + sizeof(line);
+  getClipRect(&clipX0, &cy0, &clipX1, &cy1);
+  if (clipX0 > clipX1 || cy0 > cy1) return;
+
+  if (!sink) {
+    // ops recorded so far must reach the panel before this does
+    dlSync();
+
+    startWrite();
+    setAddrWindow(clipX0, cy0, clipX1, cy1);
+  }
+  for (y = cy0; y <= cy1; y++) {
+    // shapes leaving and joining the active list, which stays in the
+    // order the shapes were added
+    for (i = 0, j = 0; i < numActive; i++) {
+      if (shapes[active[i]].bottom >= y) active[j++] = active[i];
+    }
+    numActive = j;
+    for (; next < numShapes && shapes[byTop[next]].top <= y; next++) {
+      if (shapes[byTop[next]].bottom < y) continue;
+      for (i = numActive; i > 0 && active[i-1] > byTop[next]; i--) {
+        active[i] = active[i-1];
+      }
+      active[i] = byTop[next];
+      numActive++;
+    }
+
+    if (backdrop) {
+      backdrop(line, y, clipX0, clipX1);
+    } else {
+      span(clipX0, clipX1, scanBg);
+    }
+    for (i = 0; i < numActive; i++) {
+      shapeRow(&shapes[active[i]], y);
+    }
+    if (sink) {
+      sink(line, y, clipX0, clipX1);
+    } else {
+      pushPixels(line + 2 * clipX0, clipX1 - clipX0 + 1);
+    }
+    scanStats.rows++;
+  }
+  if (!sink) endWrite();
+}
+
+void scanEnd(void) {
+  scanRender(0, 0);
+  numShapes = 0;
+  markShapes = markSpans = 0;
+}
+
+unsigned int scanShapeCount(void) {
+  return numShapes;
+}
+
+void scanMark(void) {
+  markShapes = numShapes;
+  markSpans = spanUsed;
+}
+
+// Drops the shapes added since scanMark(), or since scanBegin() without one
+void scanRewind(void) {
+  unsigned int i, j;
+
+  for (i = 0, j = 0; i < numShapes; i++) {
+    if (byTop[i] < markShapes) byTop[j++] = byTop[i];
+  }
+  numShapes = markShapes;
+  spanUsed = markSpans;
+}
+
+// Columns and rows shape i of the frame can touch, inclusive
+void scanShapeBox(unsigned int i, int *x0, int *y0, int *x1, int *y1) {
+  const ScanShape *s = &shapes[i];
+  const SpriteFrame *f;
+
+  *y0 = s->top;
+  *y1 = s->bottom;
+  switch (s->type) {
+  case SCAN_RECT:
+  case SCAN_LINE:
+    *x0 = s->x0;
+    *x1 = s->x1;
+    break;
+  case SCAN_STEEP_LINE:
+    *x0 = s->y0 < s->y1 ? s->y0 : s->y1;
+    *x1 = s->y0 < s->y1 ? s->y1 : s->y0;
+    break;
+  case SCAN_CIRCLE:
+  case SCAN_FILL_CIRCLE:
+    *x0 = s->x0 - s->x1;
+    *x1 = s->x0 + s->x1;
+    break;
+  case SCAN_TEXT:
+    *x0 = s->x0;
+    *x1 = s->x0 + 6 * s->size * s->x1 - 1;
+    break;
+  case SCAN_XBM:
+  case SCAN_RGB:
+    *x0 = s->x0;
+    *x1 = s->x0 + s->x1 - 1;
+    break;
+  case SCAN_SPRITE:
+    f = (const SpriteFrame *)s->data;
+    *x0 = s->x0;
+    *x1 = s->x0 + f->w - 1;
+    break;
+  }
+}
+
+void getScanlineStats(ScanlineStats *stats) {
+  *stats = scanStats;
+}
@@ -0,0 +1,57 @@
+/*
+ * scanline.h
+ *
+ * Renders a frame one pixel row at a time from a list of shapes, without a
+ * framebuffer: each row is composed in a row buffer and streamed into one
+ * window covering the clip rectangle, so every pixel is sent exactly once.
+ */
+
+#ifndef OLED_SCANLINE_H_
+#define OLED_SCANLINE_H_
+
+#include "sprite.h"
+
+// Shapes a frame can hold; shapes added to a full list are dropped
+#ifndef SCAN_MAX_SHAPES
+#define SCAN_MAX_SHAPES 24
+#endif
+
+// Bytes of circle spans a frame can hold: 2*(r+1) for an outline, r+1 for
+// a fill
+#ifndef SCAN_SPAN_BYTES
+#define SCAN_SPAN_BYTES 128
+#endif
+
+typedef struct {
+  unsigned long shapes;         // shapes rendered in the last frame
+  unsigned long shapesDropped;  // list or span pool full
+  unsigned long rows;           // rows sent
+  unsigned long spans;          // spans written to the row buffer
+  unsigned int ramBytes;        // shape list, span pool and row buffer
+} ScanlineStats;
+
+// Row hooks for scanRender(): line holds a row in panel byte order, two
+// bytes a pixel from column 0; columns x0..x1 of row y are in use
+typedef void (*ScanRowFn)(unsigned char *line, int y, int x0, int x1);
+
+void scanBegin(unsigned int bg);
+void scanEnd(void);
+void scanRender(ScanRowFn backdrop, ScanRowFn sink);
+unsigned int scanShapeCount(void);
+void scanMark(void);
+void scanRewind(void);
+void scanShapeBox(unsigned int i, int *x0, int *y0, int *x1, int *y1);
+int scanFillRect(int x, int y, int w, int h, unsigned int color);
+int scanLine(int x0, int y0, int x1, int y1, unsigned int color);
+int scanCircle(int x0, int y0, int r, unsigned int color);
+int scanFillCircle(int x0, int y0, int r, unsigned int color);
+int scanString(int x, int y, const char *str, int n,
+               unsigned int color, unsigned int bg, unsigned char size);
+int scanXBitmap(int x, int y, const unsigned char *bitmap, int w, int h,
+                unsigned int color);
+int scanRGBBitmap(int x, int y, const unsigned int *pixels, int w, int h,
+                  int stride, const unsigned int *keys, int numKeys);
+int scanSprite(const SpriteFrame *f, int x, int y);
+void getScanlineStats(ScanlineStats *stats);
+
+#endif /* OLED_SCANLINE_H_ */
@@ -0,0 +1,194 @@
+/*
+ * sprite.c
+ *
+ * spriteDraw() sends each run of opaque pixels in a row straight from the
+ * frame's pixel data as one window; in framebuffer mode the same windows
+ * composite the sprite into RAM. spriteDrawOpaque() sends the whole frame
+ * through a single window, with transparent pixels in a background colour.
+ * spriteErase() fills the opaque runs with a colour, which takes a moving
+ * sprite off a plain background without touching its surroundings.
+ *
+ * spriteDrawRotated() draws a frame turned to any angle and scaled, straight
+ * from the frame's pixels each time: every pixel of the destination window
+ * is mapped back into the frame with Q16 steps from a sine table, so no
+ * rounding builds up from one angle to the next.
+ *
+ * Everything is clipped to the clip rectangle (see pushClipRect()).
+ * Drawing goes to the panel directly, so the display list is sent first
+ * (see dlSync()).
+ */
+
+#include "Adafruit_SSD1351.h"
+#include "Adafruit_GFX.h"
+#include "display_list.h"
+#include "sin_table.h"
+#include "sprite.h"
+
+// Runs of opaque pixels, clipped, with their colour or with
+// the frame's own pixels when fill is 0
+static void spriteRuns(const SpriteFrame *f, int x, int y,
+                       const unsigned int *fill) {
+  int maskWidth = (f->w + 7) / 8;
+  int from, to, top, bottom, j, col, start, len;
+
+  x += f->ox;
+  y += f->oy;
+  if (!clipImage(x, y, f->w, f->h, &from, &to, &top, &bottom)) return;
+
+  dlSync();
+
+  startWrite();
+  for (j = top; j < bottom; j++) {
+    for (col = from; (len = xbmNextRun(f->mask + j * maskWidth, col, to, &start));
+         col = start + len) {
+      setAddrWindow(x + start, y + j, x + start + len - 1, y + j);
+      if (fill) {
+        pushColor(*fill, len);
+      } else {
+        pushPixels(f->pixels + 2 * (j * f->w + start), len);
+      }
+    }
+  }
+  endWrite();
+}
+
+void spriteDraw(const SpriteFrame *f, int x, int y) {
+  spriteRuns(f, x, y, 0);
+}
+
+void spriteErase(const SpriteFrame *f, int x, int y, unsigned int bg) {
+  spriteRuns(f, x, y, &bg);
+}
+
+void spriteDrawOpaque(const SpriteFrame *f, int x, int y, unsigned int bg) {
+  unsigned char line[2 * SSD1351WIDTH];
+  const unsigned char *mask, *pixels;
+  int maskWidth = (f->w + 7) / 8;
+  int from, to, top, bottom, i, j;
+
+  x += f->ox;
+  y += f->oy;
+  if (!clipImage(x, y, f->w, f->h, &from, &to, &top, &bottom)) return;
+
+  dlSync();
+
+  startWrite();
+  setAddrWindow(x + from, y + top, x + to - 1, y + bottom - 1);
+  for (j = top; j < bottom; j++) {
+    mask = f->mask + j * maskWidth;
+    pixels = f->pixels + 2 * j * f->w;
+    for (i = from; i < to; i++) {
+      if (mask[i >> 3] & (1 << (i & 7))) {
+        line[2*(i-from)]   = pixels[2*i];
+        line[2*(i-from)+1] = pixels[2*i+1];
+      } else {
+        line[2*(i-from)]   = bg >> 8;
+        line[2*(i-from)+1] = bg;
+      }
+    }
+    pushPixels(line, to - from);
+  }
+  endWrite();
+}
+
+// sin and cos of angle degrees in Q16
+static int sinQ16(int angle) {
+  angle %= 360;
+  if (angle < 0) angle += 360;
+  if (angle <= 90) return sinQ16Table[angle];
+  if (angle <= 180) return sinQ16Table[180 - angle];
+  if (angle <= 270) return -sinQ16Table[angle - 180];
+  return -sinQ16Table[360 - angle];
+}
+
+static int cosQ16(int angle) {
+  return sinQ16(angle + 90);
+}
+
+// Screen box of f turned by angle degrees (counterclockwise, as the cannon
+// directions go) and scaled by scale (Q16, 65536 = same size) about its
+// hot spot at x, y; a pixel wider all round than the turned corners
+void spriteRotatedBounds(const SpriteFrame *f, int x, int y, int angle,
+                         int scale, int *x0, int *y0, int *x1, int *y1) {
+  // scale is kept to 8 fraction bits so the products fit 32 bits
+  int c = (cosQ16(angle) >> 8) * (scale >> 8);
+  int s = (sinQ16(angle) >> 8) * (scale >> 8);
+  int k, u, v, px, py;
+
+  *x0 = *y0 = 0x7FFFFFFF;
+  *x1 = *y1 = -0x7FFFFFFF;
+  for (k = 0; k < 4; k++) {
+    u = f->ox + (k & 1 ? f->w - 1 : 0);
+    v = f->oy + (k & 2 ? f->h - 1 : 0);
+    px = (u * c + v * s) >> 16;
+    py = (v * c - u * s) >> 16;
+    if (px < *x0) *x0 = px;
+    if (px > *x1) *x1 = px;
+    if (py < *y0) *y0 = py;
+    if (py > *y1) *y1 = py;
+  }
+  *x0 += x - 1;
+  *y0 += y - 1;
+  *x1 += x + 1;
+  *y1 += y + 1;
+}
+
+// Each pixel of the box from spriteRotatedBounds() takes the frame pixel
+// nearest to where it maps back to, or bg where that is transparent or
+// outside the frame; the box goes out as one window
+void spriteDrawRotated(const SpriteFrame *f, int x, int y, int angle,
+                       int scale, unsigned int bg) {
+  unsigned char line[2 * SSD1351WIDTH];
+  int maskWidth = (f->w + 7) / 8;
+  int bx0, by0, bx1, by1, i, j, n;
+  int du, dv, u, v, rowU, rowV;
+  unsigned char *p;
+
+  if (scale < 256) return;
+  spriteRotatedBounds(f, x, y, angle, scale, &bx0, &by0, &bx1, &by1);
+  if (!clipRect(&bx0, &by0, &bx1, &by1)) return;
+
+  // frame steps per screen pixel: the inverse turn, divided by the scale
+  du = cosQ16(angle) * 256 / (scale >> 8);
+  dv = sinQ16(angle) * 256 / (scale >> 8);
+
+  // frame position of the first pixel, relative to the hot spot, plus a
+  // half so that truncating rounds to the nearest pixel
+  rowU = (bx0 - x) * du - (by0 - y) * dv + 0x8000 - f->ox * 65536;
+  rowV = (bx0 - x) * dv + (by0 - y) * du + 0x8000 - f->oy * 65536;
+
+  dlSync();
+
+  startWrite();
+  setAddrWindow(bx0, by0, bx1, by1);
+  n = bx1 - bx0 + 1;
+  for (j = by0; j <= by1; j++) {
+    u = rowU;
+    v = rowV;
+    p = line;
+    for (i = 0; i < n; i++) {
+      int fi = u >> 16, fj = v >> 16;
+
+      if (fi >= 0 && fi < f->w && fj >= 0 && fj < f->h &&
+          (f->mask[fj * maskWidth + (fi >> 3)] & (1 << (fi & 7)))) {
+        p[0] = f->pixels[2 * (fj * f->w + fi)];
+        p[1] = f->pixels[2 * (fj * f->w + fi) + 1];
+      } else {
+        p[0] = bg >> 8;
+        p[1] = bg;
+      }
+      p += 2;
+      u += du;
+      v += dv;
+    }
+    pushPixels(line, n);
+    rowU -= dv;
+    rowV += du;
+  }
+  endWrite();
+}
+
+// Bytes of pixel and mask data one frame takes
+unsigned int spriteFrameBytes(const SpriteFrame *f) {
+  return f->w * f->h * 2 + ((f->w + 7) / 8) * f->h;
+}
@@ -0,0 +1,27 @@
+/*
+ * sprite.h
+ *
+ * Pre-rendered RGB565 images with a transparency mask, drawn at a hot spot.
+ */
+
+#ifndef OLED_SPRITE_H_
+#define OLED_SPRITE_H_
+
+typedef struct {
+  unsigned char w, h;
+  signed char ox, oy;            // top left relative to the sprite position
+  const unsigned char *pixels;   // w*h pixels, row by row, high byte first
+  const unsigned char *mask;     // (w+7)/8 bytes a row, bit i set if column i
+                                 // is opaque (XBM bit order)
+} SpriteFrame;
+
+void spriteDraw(const SpriteFrame *f, int x, int y);
+void spriteDrawOpaque(const SpriteFrame *f, int x, int y, unsigned int bg);
+void spriteErase(const SpriteFrame *f, int x, int y, unsigned int bg);
+void spriteDrawRotated(const SpriteFrame *f, int x, int y, int angle,
+                       int scale, unsigned int bg);
+void spriteRotatedBounds(const SpriteFrame *f, int x, int y, int angle,
+                         int scale, int *x0, int *y0, int *x1, int *y1);
+unsigned int spriteFrameBytes(const SpriteFrame *f);
+
+#endif /* OLED_SPRITE_H_ */
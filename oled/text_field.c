@@ -0,0 +1,87 @@
+/*
+ * text_field.c
+ *
+ * Characters are laid out in the field's box like Outstr lays them out on
+ * the screen: with wrap set, a character that would cross the right edge of
+ * the box starts a new line at the box's left edge; without it, characters
+ * past the edge are not drawn. textFieldSet() compares the new text with
+ * what the field shows, position by position (positions past the end of a
+ * string count as blanks), and redraws each run of changed characters on a
+ * line as one drawString(). A score going from 9 to 10 redraws two glyphs in
+ * one window, from 10 to 11 a single glyph.
+ */
+
+#include <string.h>
+
+#include "Adafruit_GFX.h"
+#include "Adafruit_SSD1351.h"
+#include "text_field.h"
+
+static int fieldCols(const TextField *f) {
+  int cols = f->w / (6 * f->size);
+
+  return cols > 0 ? cols : 1;
+}
+
+static char fieldChar(const char *text, int len, int i) {
+  return i < len ? text[i] : ' ';
+}
+
+void textFieldInit(TextField *f, int x, int y, int w,
+                   unsigned int color, unsigned int bg, unsigned char size) {
+  f->x = x;
+  f->y = y;
+  f->w = w;
+  f->color = color;
+  f->bg = bg;
+  f->size = size > 0 ? size : 1;
+  f->shown[0] = '\0';
+  f->valid = 1;
+  f->glyphsDrawn = 0;
+}
+
+// Redraw everything on the next textFieldSet(), e.g. after the screen was
+// cleared to bg
+void textFieldInvalidate(TextField *f) {
+  f->valid = 0;
+}
+
+void textFieldSet(TextField *f, const char *text) {
+  char run[TEXT_FIELD_MAX];
+  int cols = fieldCols(f);
+  int oldLen = strlen(f->shown);
+  int newLen = strlen(text);
+  int len, i, n, col, line;
+
+  if (newLen > TEXT_FIELD_MAX) newLen = TEXT_FIELD_MAX;
+  len = newLen > oldLen ? newLen : oldLen;
+  if (!getTextWrap() && len > cols) len = cols;
+
+  startWrite();
+  for (i = 0; i < len; i += n) {
+    n = 0;
+    while (i + n < len &&
+           (!f->valid || fieldChar(text, newLen, i + n) !=
+                         fieldChar(f->shown, oldLen, i + n))) {
+      run[n] = fieldChar(text, newLen, i + n);
+      n++;
+      // a run stops at the end of a line
+      if ((i + n) % cols == 0) break;
+    }
+    if (n == 0) {
+      n = 1;
+      continue;
+    }
+
+    col = i % cols;
+    line = i / cols;
+    drawString(f->x + 6 * f->size * col, f->y + 8 * f->size * line,
+               run, n, f->color, f->bg, f->size);
+    f->glyphsDrawn += n;
+  }
+  endWrite();
+
+  memcpy(f->shown, text, newLen);
+  f->shown[newLen] = '\0';
+  f->valid = 1;
+}
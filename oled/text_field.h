@@ -0,0 +1,29 @@
+/*
+ * text_field.h
+ *
+ * A piece of HUD text that remembers what it shows on the panel, so that
+ * setting new text only redraws the characters that changed.
+ */
+
+#ifndef OLED_TEXT_FIELD_H_
+#define OLED_TEXT_FIELD_H_
+
+// Characters a field can hold
+#define TEXT_FIELD_MAX 32
+
+typedef struct {
+  int x, y;                         // top left
+  int w;                            // box width in pixels
+  unsigned int color, bg;           // drawn opaque: bg also erases
+  unsigned char size;
+  char valid;                       // shown matches the panel
+  char shown[TEXT_FIELD_MAX + 1];
+  unsigned long glyphsDrawn;        // characters written since init
+} TextField;
+
+void textFieldInit(TextField *f, int x, int y, int w,
+                   unsigned int color, unsigned int bg, unsigned char size);
+void textFieldSet(TextField *f, const char *text);
+void textFieldInvalidate(TextField *f);
+
+#endif /* OLED_TEXT_FIELD_H_ */